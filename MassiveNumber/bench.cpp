@@ -0,0 +1,319 @@
+#include "massive_int.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Operand sizes are in limbs and sweep 1 to 1M by powers of 8. Run with
+// --benchmark_out=<file> --benchmark_out_format=json to keep the results.
+
+namespace {
+
+constexpr int64_t minLimbs = 1;
+constexpr int64_t maxLimbs = 1 << 20;
+
+BigInt randomBigInt(size_t limbs, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    BigInt ret(rng, limbs);
+    // Keep the top limb nonzero so that the operand has exactly the requested size
+    ret.limbAt(limbs - 1) |= 1ULL << 63;
+    return ret;
+}
+
+void setLimbsProcessed(benchmark::State& state, int64_t limbs) {
+    state.SetBytesProcessed(state.iterations() * limbs * int64_t(sizeof(uint64_t)));
+    state.SetComplexityN(limbs);
+}
+
+void BM_Mult(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1), b = randomBigInt(n, 2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.mult(b));
+    setLimbsProcessed(state, 2 * n);
+}
+
+// Multiplication above mpn::parallelThreshold with the thread count as second argument
+void BM_MultThreads(benchmark::State& state) {
+    size_t n = state.range(0);
+    size_t threads = mpn::parallelThreads();
+    mpn::setParallelThreads(state.range(1));
+    BigInt a = randomBigInt(n, 1), b = randomBigInt(n, 2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.mult(b));
+    mpn::setParallelThreads(threads);
+    setLimbsProcessed(state, 2 * n);
+    state.counters["threads"] = double(state.range(1));
+}
+
+void BM_Square(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.square());
+    setLimbsProcessed(state, n);
+}
+
+// r = a * b + c evaluated into the capacity r already has
+void BM_MulAdd(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1), b = randomBigInt(n, 2), c = randomBigInt(n, 3), r;
+    for (auto _ : state) {
+        r = a * b + c;
+        benchmark::ClobberMemory();
+    }
+    setLimbsProcessed(state, 2 * n);
+}
+
+// Truncated product of two FixedInt<Bits>, compare with BM_Mult at Bits / 64 limbs
+template <size_t Bits>
+void BM_FixedMul(benchmark::State& state) {
+    FixedInt<Bits> a(randomBigInt(Bits / 64, 1)), b(randomBigInt(Bits / 64, 2));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a * b);
+    }
+    setLimbsProcessed(state, 2 * (Bits / 64));
+}
+
+template <size_t Bits>
+void BM_FixedAdd(benchmark::State& state) {
+    FixedInt<Bits> a(randomBigInt(Bits / 64, 1)), b(randomBigInt(Bits / 64, 2));
+    for (auto _ : state) {
+        a += b;
+        benchmark::ClobberMemory();
+    }
+    setLimbsProcessed(state, Bits / 64);
+}
+
+void BM_Adda(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1), b = randomBigInt(n, 2);
+    for (auto _ : state) {
+        a.adda(b);
+        benchmark::ClobberMemory();
+    }
+    setLimbsProcessed(state, n);
+}
+
+void BM_Suba(benchmark::State& state) {
+    size_t n = state.range(0);
+    // One extra limb on the minuend so that it stays above b for 2^64 iterations
+    BigInt a = randomBigInt(n + 1, 1), b = randomBigInt(n, 2);
+    for (auto _ : state) {
+        a.suba(b);
+        benchmark::ClobberMemory();
+    }
+    setLimbsProcessed(state, n);
+}
+
+void BM_Moda(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(2 * n, 1), m = randomBigInt(n, 2);
+    for (auto _ : state) {
+        BigInt t = a;
+        benchmark::DoNotOptimize(t.moda(m));
+    }
+    setLimbsProcessed(state, 2 * n);
+}
+
+void BM_Barrett(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(2 * n, 1), m = randomBigInt(n, 2);
+    BarrettContext ctx(m);
+    for (auto _ : state) {
+        BigInt t = a;
+        benchmark::DoNotOptimize(ctx.reduce(t));
+    }
+    setLimbsProcessed(state, 2 * n);
+}
+
+void BM_Divmod(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(2 * n, 1), d = randomBigInt(n, 2);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.divmod(d));
+    setLimbsProcessed(state, 2 * n);
+}
+
+void BM_Div(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.div(1000000007ULL));
+    setLimbsProcessed(state, n);
+}
+
+void BM_ModPow(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt b = randomBigInt(n, 1), e = randomBigInt(n, 2), m = randomBigInt(n, 3);
+    m.limbAt(0) |= 1;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(b.modPow(e, m));
+    setLimbsProcessed(state, n);
+}
+
+// 64 exponentiations modulo one odd modulus through the batch API
+void BM_ModPowBatch(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt m = randomBigInt(n, 3);
+    m.limbAt(0) |= 1;
+    MontgomeryContext ctx(m);
+    std::vector<BigInt> bases, exps;
+    for (uint64_t i = 0; i < 64; i++) {
+        bases.push_back(randomBigInt(n, 4 + 2 * i));
+        exps.push_back(randomBigInt(n, 5 + 2 * i));
+    }
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ctx.powBatch(bases, exps));
+    setLimbsProcessed(state, 64 * n);
+}
+
+void BM_ToString(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.toString());
+    setLimbsProcessed(state, n);
+}
+
+void BM_ToStringBase(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.toString(7));
+    setLimbsProcessed(state, n);
+}
+
+void BM_Parse(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::string s = randomBigInt(n, 1).toString();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(BigInt(std::string_view(s)));
+    setLimbsProcessed(state, n);
+    state.counters["digits"] = double(s.size());
+}
+
+// Power of two radixes are bit extraction, linear in the size
+void BM_ToHex(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.hexString());
+    setLimbsProcessed(state, n);
+}
+
+void BM_FromHex(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::string s = randomBigInt(n, 1).hexString();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(BigInt::fromHex(s));
+    setLimbsProcessed(state, n);
+}
+
+void BM_ToBase64(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.toBase64());
+    setLimbsProcessed(state, n);
+}
+
+void BM_FromBase64(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::string s = randomBigInt(n, 1).toBase64();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(BigInt::fromBase64(s));
+    setLimbsProcessed(state, n);
+}
+
+// Binary checkpoint format, compare with BM_ToString and BM_Parse
+void BM_ToBinary(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    std::vector<unsigned char> buf(a.binarySize());
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a.toBinary(buf.data(), buf.data() + buf.size()));
+    setLimbsProcessed(state, n);
+}
+
+void BM_FromBinary(benchmark::State& state) {
+    size_t n = state.range(0);
+    std::vector<unsigned char> buf = randomBigInt(n, 1).toBinary();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(BigInt::fromBinary(buf.data(), buf.data() + buf.size()));
+    setLimbsProcessed(state, n);
+}
+
+void BM_ShiftLeft(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a << 100);
+    setLimbsProcessed(state, n);
+}
+
+void BM_ShiftRight(benchmark::State& state) {
+    size_t n = state.range(0);
+    BigInt a = randomBigInt(n, 1);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(a >> 100);
+    setLimbsProcessed(state, n);
+}
+
+void limbSweep(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(8)->Range(minLimbs, maxLimbs)->Unit(benchmark::kMicrosecond)->Complexity();
+}
+
+// A full size exponent costs 64n modular products, so one run at 512 limbs already takes seconds
+void modPowSweep(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(2)->Range(minLimbs, 128)->Unit(benchmark::kMicrosecond)->Complexity();
+}
+
+void threadSweep(benchmark::internal::Benchmark* b) {
+    int64_t hw = std::max(1u, std::thread::hardware_concurrency());
+    for (int64_t n = 1 << 14; n <= maxLimbs; n <<= 3)
+        for (int64_t t = 1; t <= hw; t *= 2)
+            b->Args({n, t});
+    b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+} // namespace
+
+BENCHMARK(BM_Mult)->Apply(limbSweep);
+BENCHMARK(BM_MultThreads)->Apply(threadSweep);
+BENCHMARK(BM_Square)->Apply(limbSweep);
+BENCHMARK(BM_MulAdd)->Apply(limbSweep);
+BENCHMARK_TEMPLATE(BM_FixedMul, 256);
+BENCHMARK_TEMPLATE(BM_FixedMul, 512);
+BENCHMARK_TEMPLATE(BM_FixedMul, 2048);
+BENCHMARK_TEMPLATE(BM_FixedMul, 4096);
+BENCHMARK(BM_Adda)->Apply(limbSweep);
+BENCHMARK_TEMPLATE(BM_FixedAdd, 256);
+BENCHMARK_TEMPLATE(BM_FixedAdd, 512);
+BENCHMARK_TEMPLATE(BM_FixedAdd, 2048);
+BENCHMARK_TEMPLATE(BM_FixedAdd, 4096);
+BENCHMARK(BM_Suba)->Apply(limbSweep);
+BENCHMARK(BM_Moda)->Apply(limbSweep);
+BENCHMARK(BM_Barrett)->Apply(limbSweep);
+BENCHMARK(BM_Divmod)->Apply(limbSweep);
+BENCHMARK(BM_Div)->Apply(limbSweep);
+BENCHMARK(BM_ModPow)->Apply(modPowSweep);
+BENCHMARK(BM_ModPowBatch)->RangeMultiplier(2)->Range(minLimbs, 64)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ToString)->Apply(limbSweep);
+// Generic bases are converted by repeated division, which is quadratic
+BENCHMARK(BM_ToStringBase)->RangeMultiplier(8)->Range(minLimbs, 4096)->Unit(benchmark::kMicrosecond)->Complexity();
+BENCHMARK(BM_Parse)->Apply(limbSweep);
+BENCHMARK(BM_ToHex)->Apply(limbSweep);
+BENCHMARK(BM_FromHex)->Apply(limbSweep);
+BENCHMARK(BM_ToBase64)->Apply(limbSweep);
+BENCHMARK(BM_FromBase64)->Apply(limbSweep);
+BENCHMARK(BM_ToBinary)->Apply(limbSweep);
+BENCHMARK(BM_FromBinary)->Apply(limbSweep);
+BENCHMARK(BM_ShiftLeft)->Apply(limbSweep);
+BENCHMARK(BM_ShiftRight)->Apply(limbSweep);
+
+BENCHMARK_MAIN();
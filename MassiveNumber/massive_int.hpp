@@ -2,18 +2,45 @@
 #define BIGINT64_HPP
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
 #include <cassert>
 #include <algorithm>
 #include <iterator>
+#include <utility>
+#include <new>
+#include <stdexcept>
 #include <limits>
 #include <initializer_list>
+#include <type_traits>
 #include <deque>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <bitset>
 #include <array>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <system_error>
+#include <cerrno>
+#include <unordered_map>
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#define BIGINT_HAS_FD 1
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#define BIGINT_HAS_MMAP 1
+#endif
+#endif
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define BIGINT_BIG_ENDIAN 1
+#endif
 #ifndef INTRIN_HPP
 #define INTRIN_HPP
 #include <cstdint>
@@ -580,6 +607,18 @@ inline unsigned long long mulx_u64(unsigned long long a, unsigned long long b, u
 	*hi = (unsigned long long)(r >> 64);
 	return r;
 }
+inline unsigned char _addc_u64(unsigned char c, unsigned long long a, unsigned long long b, unsigned long long* out){
+	unsigned long long s;
+	unsigned char c1 = __builtin_uaddll_overflow(a, b, &s);
+	unsigned char c2 = __builtin_uaddll_overflow(s, (unsigned long long)c, out);
+	return c1 | c2;
+}
+inline unsigned char _subb_u64(unsigned char c, unsigned long long a, unsigned long long b, unsigned long long* out){
+	unsigned long long s;
+	unsigned char c1 = __builtin_usubll_overflow(a, b, &s);
+	unsigned char c2 = __builtin_usubll_overflow(s, (unsigned long long)c, out);
+	return c1 | c2;
+}
 #elif defined(_MSC_VER)
 #include <intrin.h>
 inline int _leading_zeros(unsigned long long x){
@@ -602,6 +641,12 @@ inline bool _sbc_u64(unsigned long long a,unsigned long long b,unsigned long lon
 inline unsigned long long mulx_u64(unsigned long long a, unsigned long long b, unsigned long long* hi){
 	return _mulx_u64(a,b,hi);
 }
+inline unsigned char _addc_u64(unsigned char c, unsigned long long a, unsigned long long b, unsigned long long* out){
+	return _addcarry_u64(c, a, b, out);
+}
+inline unsigned char _subb_u64(unsigned char c, unsigned long long a, unsigned long long b, unsigned long long* out){
+	return _subborrow_u64(c, a, b, out);
+}
 #else
 
 #error Your compiler is neither GNU nor Clang nor MSVC
@@ -614,7 +659,29 @@ inline unsigned long long mulx_u64(unsigned long long a, unsigned long long b, u
 #ifdef max
 #undef max
 #endif
-constexpr static std::array<char, 16> chars = {'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f'};
+//Digits of bases up to 36
+constexpr static std::array<char, 36> chars = {'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f','g','h','i','j','k','l',
+                                               'm','n','o','p','q','r','s','t','u','v','w','x','y','z'};
+//Value of a digit character in either case, 255 for anything else
+constexpr std::array<unsigned char, 256> makeDigitValues(){
+	std::array<unsigned char, 256> t{};
+	for(unsigned int c = 0;c < 256;c++)t[c] = 255;
+	for(unsigned int i = 0;i < 10;i++)t['0' + i] = (unsigned char)i;
+	for(unsigned int i = 0;i < 26;i++)t['a' + i] = t['A' + i] = (unsigned char)(10 + i);
+	return t;
+}
+constexpr static std::array<unsigned char, 256> digitValues = makeDigitValues();
+//RFC 4648 base64 alphabets, the second one is the URL and file name safe variant
+constexpr static char base64Chars[2][65] = {"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/",
+                                             "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"};
+//Value of a character of either base64 alphabet, 255 for anything else
+constexpr std::array<unsigned char, 256> makeBase64Values(){
+	std::array<unsigned char, 256> t{};
+	for(unsigned int c = 0;c < 256;c++)t[c] = 255;
+	for(unsigned int i = 0;i < 64;i++)t[(unsigned char)base64Chars[0][i]] = t[(unsigned char)base64Chars[1][i]] = (unsigned char)i;
+	return t;
+}
+constexpr static std::array<unsigned char, 256> base64Values = makeBase64Values();
 template<typename T>
 inline int signum(T t){
 	if(t < 0)return -1;
@@ -622,6 +689,19 @@ inline int signum(T t){
     assert(false && "t is neither >= nor < 0");
 	return 0;
 }
+//"00" to "99", two decimal digits per lookup
+constexpr static char digitPairs[201] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+//Writes the 9 decimal digits of v < 10^9 to dest, zero padded
+inline void nineDigits(char dest[], uint32_t v){
+	dest[8] = (char)('0' + v % 10);
+	v /= 10;
+	for(int i = 3;i >= 0;i--){
+		std::memcpy(dest + 2 * i, digitPairs + 2 * (v % 100), 2);
+		v /= 100;
+	}
+}
 inline void singleHex(char dest[], uint64_t nr){
 	uint64_t mask = 0xf000000000000000;
 	for(unsigned int i = 0;i < 16;i++){
@@ -630,480 +710,2608 @@ inline void singleHex(char dest[], uint64_t nr){
 	}
 	dest[16] = 0;
 }
-struct BigInt{
-	using lui = ::uint_128bit;
-	using size_t = std::size_t;
-	using ssize_t = std::int64_t;
-	using uint64_t = std::uint64_t;
-	using uint32_t = std::uint32_t;
-	using iterator = std::deque<uint64_t>::iterator;
-	using const_iterator = std::deque<uint64_t>::const_iterator;
-	using reverse_iterator = std::deque<uint64_t>::reverse_iterator;
-	using const_reverse_iterator = std::deque<uint64_t>::const_reverse_iterator;
-	std::deque<uint64_t> data;
-	int signum;
-	inline BigInt() : data(1,0),signum(1){}
-	inline BigInt(size_t _s, uint64_t fill) : data(_s, fill), signum(1){}
-	inline BigInt(int a) :  data(1, std::abs(a)),signum(::signum(a)){}
-	inline BigInt(unsigned int a) : data(1, a),signum(1){}
-	inline BigInt(unsigned long long a) : data(1, a), signum(1){}
-	inline BigInt(long long a) : data(1, std::abs(a)),signum(::signum(a)){}
-	inline BigInt(const std::initializer_list<uint64_t>& l) : data(l), signum(1){}
-	inline BigInt(std::initializer_list<uint64_t>&& l) : data(std::move(l)), signum(1){}
-	inline BigInt(const BigInt& o) : data(o.data), signum(o.signum){}
-	inline BigInt(BigInt&& o) : data(std::move(o.data)), signum(o.signum){}
-	template<typename InputIterator>
-	inline BigInt(InputIterator begin, InputIterator end) : data(begin, end), signum(1){}
-	template<typename RNG>
-	inline BigInt(RNG& rng, size_t length) : data(length, 0), signum(1){std::generate(data.begin(),data.end(), [&rng](){return rng();});}
-	inline std::deque<uint64_t>::iterator begin(){return data.begin();}
-	inline std::deque<uint64_t>::iterator end(){return data.end();}
-	inline std::deque<uint64_t>::reverse_iterator rbegin(){return data.rbegin();}
-	inline std::deque<uint64_t>::reverse_iterator rend(){return data.rend();}
-	inline std::deque<uint64_t>::const_iterator begin()const{return data.begin();}
-	inline std::deque<uint64_t>::const_iterator end()const{return data.end();}
-	inline std::deque<uint64_t>::const_reverse_iterator rbegin()const{return data.rbegin();}
-	inline std::deque<uint64_t>::const_reverse_iterator rend()const{return data.rend();}
-	inline std::deque<uint64_t>::const_iterator cbegin()const{return data.cbegin();}
-	inline std::deque<uint64_t>::const_iterator cend()const{return data.cend();}
-	inline std::deque<uint64_t>::const_reverse_iterator crbegin()const{return data.crbegin();}
-	inline std::deque<uint64_t>::const_reverse_iterator crend()const{return data.crend();}
-	inline uint64_t& operator[](size_t i){return data[i];}
-	inline const uint64_t& operator[](size_t i)const{return data.at(i);}
-	inline uint64_t& at(size_t i){return data[i];}
-	inline const uint64_t& at(size_t i)const{return data.at(i);}
-	inline size_t size()const{return data.size();}
-	inline BigInt& operator=(const BigInt& o){signum = o.signum;data = o.data;return *this;}
-	inline BigInt& operator=(BigInt&& o){data = std::move(o.data);signum = o.signum;return *this;}
-	inline BigInt(const std::string& o){
-		signum = 1;
-		auto it = o.rbegin();
-		BigInt baseTen(1);
-		while(it != o.rend()){
-			if(*it == '-'){
-				assert(it != o.rbegin());
-				assert((++it) == o.rend());
-				signum = -1;
-				break;
-			}
-			BigInt l = baseTen.mult(BigInt(*it - '0'));
-			adda(l);
-			baseTen = baseTen.mult(BigInt(10));
-			++it;
+/*
+ * Source of the limb storage of LimbVector. The default one is malloc/realloc/free; another one can be
+ * set with setDefaultLimbAllocator before BigInts are created, or handed to a single LimbVector.
+ */
+struct LimbAllocator{
+	virtual ~LimbAllocator() = default;
+	virtual std::uint64_t* allocate(std::size_t n) = 0;
+	//Grows p from old to n limbs keeping its first keep limbs
+	virtual std::uint64_t* reallocate(std::uint64_t* p, std::size_t old, std::size_t keep, std::size_t n) = 0;
+	virtual void deallocate(std::uint64_t* p, std::size_t n) = 0;
+};
+struct MallocLimbAllocator : LimbAllocator{
+	inline std::uint64_t* allocate(std::size_t n)override{
+		std::uint64_t* p = (std::uint64_t*)std::malloc(n * sizeof(std::uint64_t));
+		if(!p)throw std::bad_alloc();
+		return p;
+	}
+	inline std::uint64_t* reallocate(std::uint64_t* p, std::size_t, std::size_t, std::size_t n)override{
+		std::uint64_t* np = (std::uint64_t*)std::realloc(p, n * sizeof(std::uint64_t));
+		if(!np)throw std::bad_alloc();
+		return np;
+	}
+	inline void deallocate(std::uint64_t* p, std::size_t)override{std::free(p);}
+};
+/*
+ * Hands out limbs from large blocks and frees them all at once in release() or on destruction, individual
+ * deallocations are no-ops. For BigInts that live exactly as long as one computation.
+ */
+struct MonotonicLimbAllocator : LimbAllocator{
+	std::vector<std::pair<std::uint64_t*, std::size_t>> blocks;
+	std::size_t used = 0;
+	std::size_t blockLimbs;
+	inline explicit MonotonicLimbAllocator(std::size_t initialLimbs = 4096) : blockLimbs(std::max<std::size_t>(64, initialLimbs)){}
+	MonotonicLimbAllocator(const MonotonicLimbAllocator&) = delete;
+	MonotonicLimbAllocator& operator=(const MonotonicLimbAllocator&) = delete;
+	inline ~MonotonicLimbAllocator(){release();}
+	inline std::uint64_t* allocate(std::size_t n)override{
+		n = (n + 7) & ~(std::size_t)7;
+		if(blocks.empty() || blocks.back().second - used < n){
+			std::size_t size = std::max(n, blockLimbs);
+			std::uint64_t* p = (std::uint64_t*)std::malloc(size * sizeof(std::uint64_t));
+			if(!p)throw std::bad_alloc();
+			blocks.emplace_back(p, size);
+			blockLimbs = 2 * size;
+			used = 0;
 		}
-		trim();
+		std::uint64_t* p = blocks.back().first + used;
+		used += n;
+		return p;
 	}
-	inline size_t bitscanForward()const{
-		auto it = begin();
-		size_t s = 0;
-		while(*it == 0 && it != end()){
-			++it;
-			s += 64;
+	inline std::uint64_t* reallocate(std::uint64_t* p, std::size_t, std::size_t keep, std::size_t n)override{
+		std::uint64_t* np = allocate(n);
+		if(keep)std::memcpy(np, p, keep * sizeof(std::uint64_t));
+		return np;
+	}
+	inline void deallocate(std::uint64_t*, std::size_t)override{}
+	//Frees everything handed out so far
+	inline void release(){
+		for(auto& b : blocks)std::free(b.first);
+		blocks.clear();
+		used = 0;
+	}
+};
+inline MallocLimbAllocator& mallocLimbAllocator(){
+	static MallocLimbAllocator a;
+	return a;
+}
+inline LimbAllocator*& defaultLimbAllocatorSlot(){
+	static LimbAllocator* current = &mallocLimbAllocator();
+	return current;
+}
+inline LimbAllocator* defaultLimbAllocator(){return defaultLimbAllocatorSlot();}
+//The allocator of LimbVectors created from now on, null restores malloc
+inline void setDefaultLimbAllocator(LimbAllocator* a){
+	defaultLimbAllocatorSlot() = a ? a : &mallocLimbAllocator();
+}
+//Source of scratch space too large for the ScratchArena, malloc by default
+inline LimbAllocator*& scratchLimbAllocatorSlot(){
+	static LimbAllocator* current = &mallocLimbAllocator();
+	return current;
+}
+inline LimbAllocator* scratchLimbAllocator(){return scratchLimbAllocatorSlot();}
+inline void setScratchLimbAllocator(LimbAllocator* a){
+	scratchLimbAllocatorSlot() = a ? a : &mallocLimbAllocator();
+}
+#ifdef BIGINT_HAS_MMAP
+/*
+ * Keeps large limb arrays in memory mapped files, for numbers that do not fit in RAM: the kernels stream over the
+ * limbs and the kernel pages them in and out. Every array gets its own file in directory ($TMPDIR or /tmp by
+ * default), unlinked right away so nothing is left behind, and grows in place with ftruncate and mremap.
+ * Arrays below minLimbs come from malloc. Failing file operations throw std::system_error.
+ *
+ * Copies and results use the default allocator and large temporaries the scratch allocator, so for a whole
+ * computation out of core set both to this, and mpn::outOfCoreLimbs to bound the working set of products.
+ */
+struct MmapLimbAllocator : LimbAllocator{
+	struct Mapping{
+		int fd;
+		std::size_t bytes;
+	};
+	std::string directory;
+	std::size_t minLimbs;
+	std::mutex lock;
+	std::unordered_map<std::uint64_t*, Mapping> mappings;
+	inline explicit MmapLimbAllocator(std::string dir = "", std::size_t minimumLimbs = (std::size_t)1 << 20)
+	    : directory(std::move(dir)), minLimbs(std::max<std::size_t>(1, minimumLimbs)){
+		if(directory.empty()){
+			const char* tmp = std::getenv("TMPDIR");
+			directory = tmp && *tmp ? tmp : "/tmp";
 		}
-		if(it == end())return s + 64;
-		return s + _leading_zeros(*it);
 	}
-	inline size_t bitscanReverse()const{
-		auto it = rbegin();
-		size_t s = 0;
-		while(*it == 0 && it != rend()){
-			++it;
-			s += 64;
+	MmapLimbAllocator(const MmapLimbAllocator&) = delete;
+	MmapLimbAllocator& operator=(const MmapLimbAllocator&) = delete;
+	inline ~MmapLimbAllocator(){
+		for(auto& m : mappings){
+			::munmap(m.first, m.second.bytes);
+			::close(m.second.fd);
 		}
-		if(it == rend())return s + 64;
-		return s + _trailing_zeros(*it);
 	}
-	
-	inline bool operator<(const BigInt& o)const{
-		if(signum > o.signum){
-			return false;
+	[[noreturn]] static inline void fail(int error, const char* what){
+		throw std::system_error(error, std::generic_category(), std::string("MmapLimbAllocator: ") + what);
+	}
+	static inline std::size_t mappedSize(std::size_t n){
+		std::size_t page = (std::size_t)::sysconf(_SC_PAGESIZE);
+		return (n * sizeof(std::uint64_t) + page - 1) / page * page;
+	}
+	inline std::uint64_t* allocate(std::size_t n)override{
+		if(n < minLimbs)return mallocLimbAllocator().allocate(n);
+		std::string path = directory + "/bigint-XXXXXX";
+		int fd = ::mkstemp(&path[0]);
+		if(fd < 0)fail(errno, "mkstemp");
+		::unlink(path.c_str());
+		std::size_t bytes = mappedSize(n);
+		void* p = MAP_FAILED;
+		if(::ftruncate(fd, (off_t)bytes) == 0)p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if(p == MAP_FAILED){
+			int error = errno;
+			::close(fd);
+			fail(error, "mapping limbs");
 		}
-		if(signum < o.signum){
-			return true;
+		std::lock_guard<std::mutex> guard(lock);
+		mappings.emplace((std::uint64_t*)p, Mapping{fd, bytes});
+		return (std::uint64_t*)p;
+	}
+	inline std::uint64_t* reallocate(std::uint64_t* p, std::size_t old, std::size_t keep, std::size_t n)override{
+		Mapping m{-1, 0};
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto it = mappings.find(p);
+			if(it != mappings.end())m = it->second;
 		}
-		const_iterator it1 = begin();
-		const_iterator it2 = o.begin();
-		if(size() > o.size()){
-			it1 += size() - o.size();
-			auto _t = begin();
-			while(_t != it1){
-				if(*_t)return false;
-				++_t;
-			}
+		//Crossing minLimbs moves the limbs to the other kind of storage
+		if((m.fd < 0) != (n < minLimbs)){
+			std::uint64_t* np = allocate(n);
+			if(keep)std::memcpy(np, p, keep * sizeof(std::uint64_t));
+			deallocate(p, old);
+			return np;
 		}
-		else if(size() < o.size()){
-			it2 += o.size() - size();
-			auto _t = o.begin();
-			while(_t != it2){
-				if(*_t)return true;
-				++_t;
+		if(m.fd < 0)return mallocLimbAllocator().reallocate(p, old, keep, n);
+		std::size_t bytes = mappedSize(n);
+		if(bytes == m.bytes)return p;
+		//The file has to cover the mapping whenever it is touched
+		if(bytes > m.bytes && ::ftruncate(m.fd, (off_t)bytes) != 0)fail(errno, "ftruncate");
+#ifdef MREMAP_MAYMOVE
+		void* np = ::mremap(p, m.bytes, bytes, MREMAP_MAYMOVE);
+#else
+		::munmap(p, m.bytes);
+		void* np = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m.fd, 0);
+#endif
+		if(np == MAP_FAILED)fail(errno, "remapping limbs");
+		if(bytes < m.bytes && ::ftruncate(m.fd, (off_t)bytes) != 0)fail(errno, "ftruncate");
+		std::lock_guard<std::mutex> guard(lock);
+		mappings.erase(p);
+		mappings.emplace((std::uint64_t*)np, Mapping{m.fd, bytes});
+		return (std::uint64_t*)np;
+	}
+	inline void deallocate(std::uint64_t* p, std::size_t n)override{
+		Mapping m{-1, 0};
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			auto it = mappings.find(p);
+			if(it != mappings.end()){
+				m = it->second;
+				mappings.erase(it);
 			}
 		}
-		while(it1 != end() && it2 != o.end()){
-			if(*(it1) < *(it2))return true;
-			if(*(it1) > *(it2))return false;
-			++it1;++it2;
+		if(m.fd < 0)return mallocLimbAllocator().deallocate(p, n);
+		::munmap(p, m.bytes);
+		::close(m.fd);
+	}
+	//Bytes of all live mappings
+	inline std::size_t mappedBytes(){
+		std::lock_guard<std::mutex> guard(lock);
+		std::size_t ret = 0;
+		for(auto& m : mappings)ret += m.second.bytes;
+		return ret;
+	}
+};
+#endif
+//Limbs a LimbVector holds without touching its allocator, at least 1 (4 limbs cover 256 bit values)
+#ifndef BIGINT_INLINE_LIMBS
+#define BIGINT_INLINE_LIMBS 4
+#endif
+static_assert(BIGINT_INLINE_LIMBS >= 1, "BIGINT_INLINE_LIMBS must be at least 1");
+/*
+ * Contiguous limb storage, least significant limb first.
+ * Growth at the top is geometric, so appending a carry limb is amortized O(1).
+ * Up to BIGINT_INLINE_LIMBS limbs live inside the vector itself, larger storage comes from the allocator the
+ * vector was created with; copies use the default allocator, moves and swaps take the allocator along with
+ * the storage. Moving a vector with inline limbs copies them, so pointers into it do not survive a move.
+ */
+struct LimbVector{
+	using value_type = std::uint64_t;
+	using size_type = std::size_t;
+	using iterator = std::uint64_t*;
+	using const_iterator = const std::uint64_t*;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	static constexpr size_type inlineLimbs = BIGINT_INLINE_LIMBS;
+	std::uint64_t local[inlineLimbs];
+	std::uint64_t* ptr = local;
+	size_type len = 0;
+	size_type cap = inlineLimbs;
+	LimbAllocator* alloc = defaultLimbAllocator();
+	inline LimbVector(){}
+	inline explicit LimbVector(LimbAllocator* a) : alloc(a ? a : defaultLimbAllocator()){}
+	inline LimbVector(size_type n, std::uint64_t fill){resize(n, fill);}
+	inline LimbVector(std::initializer_list<std::uint64_t> l){assign(l.begin(), l.end());}
+	template<typename InputIterator, typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+	inline LimbVector(InputIterator b, InputIterator e){assign(b, e);}
+	inline LimbVector(const LimbVector& o){
+		reserve(o.len);
+		if(o.len)std::memcpy(ptr, o.ptr, o.len * sizeof(std::uint64_t));
+		len = o.len;
+	}
+	inline LimbVector(LimbVector&& o){take(o);}
+	inline ~LimbVector(){
+		if(!isInline())alloc->deallocate(ptr, cap);
+	}
+	inline bool isInline()const{return ptr == local;}
+	//Moves the storage of o into this vector, which holds no allocation; o is left empty and inline
+	inline void take(LimbVector& o){
+		alloc = o.alloc;
+		len = o.len;
+		if(o.isInline()){
+			ptr = local;
+			cap = inlineLimbs;
+			if(len)std::memcpy(local, o.local, len * sizeof(std::uint64_t));
+		}
+		else{
+			ptr = o.ptr;
+			cap = o.cap;
 		}
-		return false;
+		o.ptr = o.local;
+		o.len = 0;
+		o.cap = inlineLimbs;
 	}
-	inline bool operator>(const BigInt& o)const{
-		if(signum < o.signum){
-			return false;
+	inline LimbVector& operator=(const LimbVector& o){
+		if(this == &o)return *this;
+		len = 0;
+		reserve(o.len);
+		if(o.len)std::memcpy(ptr, o.ptr, o.len * sizeof(std::uint64_t));
+		len = o.len;
+		return *this;
+	}
+	inline LimbVector& operator=(LimbVector&& o){
+		swap(o);
+		return *this;
+	}
+	inline void swap(LimbVector& o){
+		if(this == &o)return;
+		if(!isInline() && !o.isInline()){
+			std::swap(ptr, o.ptr);
+			std::swap(len, o.len);
+			std::swap(cap, o.cap);
+			std::swap(alloc, o.alloc);
+			return;
 		}
-		if(signum > o.signum){
-			return true;
+		LimbVector t(std::move(o));
+		o.take(*this);
+		take(t);
+	}
+	template<typename InputIterator>
+	inline void assign(InputIterator b, InputIterator e){
+		len = 0;
+		for(;b != e;++b)push_back(*b);
+	}
+	inline std::uint64_t* data(){return ptr;}
+	inline const std::uint64_t* data()const{return ptr;}
+	inline size_type size()const{return len;}
+	inline size_type capacity()const{return cap;}
+	inline bool empty()const{return len == 0;}
+	inline iterator begin(){return ptr;}
+	inline iterator end(){return ptr + len;}
+	inline const_iterator begin()const{return ptr;}
+	inline const_iterator end()const{return ptr + len;}
+	inline reverse_iterator rbegin(){return reverse_iterator(end());}
+	inline reverse_iterator rend(){return reverse_iterator(begin());}
+	inline const_reverse_iterator rbegin()const{return const_reverse_iterator(end());}
+	inline const_reverse_iterator rend()const{return const_reverse_iterator(begin());}
+	inline std::uint64_t& operator[](size_type i){return ptr[i];}
+	inline const std::uint64_t& operator[](size_type i)const{return ptr[i];}
+	inline std::uint64_t& at(size_type i){
+		if(i >= len)throw std::out_of_range("LimbVector::at");
+		return ptr[i];
+	}
+	inline const std::uint64_t& at(size_type i)const{
+		if(i >= len)throw std::out_of_range("LimbVector::at");
+		return ptr[i];
+	}
+	inline std::uint64_t& front(){return ptr[0];}
+	inline const std::uint64_t& front()const{return ptr[0];}
+	inline std::uint64_t& back(){return ptr[len - 1];}
+	inline const std::uint64_t& back()const{return ptr[len - 1];}
+	inline void reserve(size_type n){
+		if(n <= cap)return;
+		if(n > std::numeric_limits<size_type>::max() / (2 * sizeof(std::uint64_t)))throw std::bad_alloc();
+		size_type ncap = std::max(n, cap + cap / 2);
+		if(isInline()){
+			std::uint64_t* nptr = alloc->allocate(ncap);
+			if(len)std::memcpy(nptr, local, len * sizeof(std::uint64_t));
+			ptr = nptr;
 		}
-		const_iterator it1 = begin();
-		const_iterator it2 = o.begin();
-		if(size() > o.size()){
-			it1 += size() - o.size();
-			auto _t = begin();
-			while(_t != it1){
-				if(*_t)return true;
-				++_t;
-			}
+		else ptr = alloc->reallocate(ptr, cap, len, ncap);
+		cap = ncap;
+	}
+	inline void resize(size_type n, std::uint64_t fill = 0){
+		reserve(n);
+		for(size_type i = len;i < n;i++)ptr[i] = fill;
+		len = n;
+	}
+	inline void push_back(std::uint64_t x){
+		if(len == cap)reserve(std::max<size_type>(4, cap * 2));
+		ptr[len++] = x;
+	}
+	inline void pop_back(){--len;}
+	inline void clear(){len = 0;}
+	//Inserts count limbs of fill below the current least significant limb
+	inline void insertLow(size_type count, std::uint64_t fill = 0){
+		reserve(len + count);
+		if(len)std::memmove(ptr + count, ptr, len * sizeof(std::uint64_t));
+		for(size_type i = 0;i < count;i++)ptr[i] = fill;
+		len += count;
+	}
+	//Drops the count least significant limbs
+	inline void eraseLow(size_type count){
+		count = std::min(count, len);
+		if(len > count)std::memmove(ptr, ptr + count, (len - count) * sizeof(std::uint64_t));
+		len -= count;
+	}
+};
+/*
+ * Stack of scratch limbs for the temporaries of the mpn kernels. Space is taken in LIFO order and handed back
+ * in bulk by returning to an earlier mark, the blocks stay around for the next computation. Every thread has
+ * an arena of its own; a ScratchScope makes the calling thread use another one for a whole computation.
+ */
+struct ScratchArena{
+	struct Block{
+		std::uint64_t* p;
+		std::size_t size;
+	};
+	struct Mark{
+		std::size_t block;
+		std::size_t used;
+	};
+	std::vector<Block> blocks;
+	std::size_t top = 0;
+	std::size_t used = 0;
+	//Larger requests go to scratchLimbAllocator(), so that no thread keeps huge blocks around
+#ifdef __SANITIZE_ADDRESS__
+	//Separate allocations let AddressSanitizer see overruns
+	static inline std::size_t maxLimbs = 0;
+#else
+	static inline std::size_t maxLimbs = (std::size_t)1 << 20;
+#endif
+	static inline thread_local ScratchArena* active = nullptr;
+	inline ScratchArena(){}
+	ScratchArena(const ScratchArena&) = delete;
+	ScratchArena& operator=(const ScratchArena&) = delete;
+	inline ~ScratchArena(){
+		for(Block& b : blocks)std::free(b.p);
+	}
+	//The arena of the calling thread
+	static inline ScratchArena& current(){
+		if(active)return *active;
+		static thread_local ScratchArena own;
+		return own;
+	}
+	inline Mark mark()const{return {top, used};}
+	inline std::uint64_t* push(std::size_t n){
+		//Whole cache lines keep every request aligned like the first one
+		n = (n + 7) & ~(std::size_t)7;
+		while(top < blocks.size() && blocks[top].size - used < n){
+			++top;
+			used = 0;
+		}
+		if(top == blocks.size()){
+			std::size_t size = std::max(n, blocks.empty() ? (std::size_t)4096 : 2 * blocks.back().size);
+			std::uint64_t* p = (std::uint64_t*)std::malloc(size * sizeof(std::uint64_t));
+			if(!p)throw std::bad_alloc();
+			blocks.push_back({p, size});
+		}
+		std::uint64_t* p = blocks[top].p + used;
+		used += n;
+		return p;
+	}
+	inline void release(Mark m){
+		top = m.block;
+		used = m.used;
+	}
+	//Frees the blocks, nothing may be taken from the arena at that point
+	inline void clear(){
+		assert(top == 0 && used == 0);
+		for(Block& b : blocks)std::free(b.p);
+		blocks.clear();
+	}
+};
+//Makes the calling thread take its scratch space from arena until the scope ends
+struct ScratchScope{
+	ScratchArena* previous;
+	inline explicit ScratchScope(ScratchArena& arena) : previous(ScratchArena::active){ScratchArena::active = &arena;}
+	inline ~ScratchScope(){ScratchArena::active = previous;}
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+};
+/*
+ * Work stealing thread pool for the parallel kernels. Every worker owns a deque, it pushes and pops its own
+ * tasks at the back and steals from the front of the others; threads outside the pool submit through one
+ * extra shared deque. Waiting on a TaskGroup runs pending tasks instead of blocking, so tasks can fork and
+ * wait on subtasks of their own.
+ */
+struct ThreadPool{
+	struct Queue{
+		std::mutex lock;
+		std::deque<std::function<void()>> tasks;
+	};
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<std::size_t> queued{0};
+	bool stopping = false;
+	std::mutex sleepLock;
+	std::condition_variable wake;
+	//The pool and queue of the calling thread when it is a worker
+	static inline thread_local ThreadPool* currentPool = nullptr;
+	static inline thread_local std::size_t currentQueue = 0;
+	inline explicit ThreadPool(std::size_t threads){
+		for(std::size_t i = 0;i <= threads;i++)queues.emplace_back(new Queue);
+		for(std::size_t i = 0;i < threads;i++)workers.emplace_back([this, i]{work(i);});
+	}
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	inline ~ThreadPool(){
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+			stopping = true;
 		}
-		else if(size() < o.size()){
-			it2 += o.size() - size();
-			auto _t = o.begin();
-			while(_t != it2){
-				if(*_t)return false;
-				++_t;
+		wake.notify_all();
+		for(std::thread& t : workers)t.join();
+	}
+	inline std::size_t size()const{return workers.size();}
+	//Queues a task, tasks must not throw (TaskGroup takes care of that)
+	inline void submit(std::function<void()> task){
+		Queue& q = *queues[currentPool == this ? currentQueue : workers.size()];
+		{
+			std::lock_guard<std::mutex> guard(q.lock);
+			q.tasks.push_back(std::move(task));
+		}
+		queued.fetch_add(1);
+		{
+			std::lock_guard<std::mutex> guard(sleepLock);
+		}
+		wake.notify_one();
+	}
+	//Runs one pending task if there is any, the caller's own newest task first and otherwise the oldest of another queue
+	inline bool runPending(){
+		if(queued.load() == 0)return false;
+		std::function<void()> task;
+		std::size_t own = currentPool == this ? currentQueue : workers.size();
+		for(std::size_t k = 0;k < queues.size() && !task;k++){
+			Queue& q = *queues[(own + k) % queues.size()];
+			std::lock_guard<std::mutex> guard(q.lock);
+			if(q.tasks.empty())continue;
+			if(k == 0){
+				task = std::move(q.tasks.back());
+				q.tasks.pop_back();
+			}
+			else{
+				task = std::move(q.tasks.front());
+				q.tasks.pop_front();
 			}
 		}
-		while(it1 != end() && it2 != o.end()){
-			if(*(it1) > *(it2))return true;
-			if(*(it1) < *(it2))return false;
-			++it1;++it2;
+		if(!task)return false;
+		queued.fetch_sub(1);
+		task();
+		return true;
+	}
+	inline void work(std::size_t index){
+		currentPool = this;
+		currentQueue = index;
+		while(true){
+			if(runPending())continue;
+			std::unique_lock<std::mutex> guard(sleepLock);
+			wake.wait(guard, [this]{return stopping || queued.load() > 0;});
+			if(stopping && queued.load() == 0)return;
 		}
-		return false;
 	}
-	inline bool operator<=(const BigInt& o)const{
-		if(signum > o.signum){
-			return false;
+};
+/*
+ * Fork-join scope on a pool: run() queues a task and wait() helps until all of them finished, rethrowing the
+ * first exception one of them threw. Without a pool run() simply calls the task.
+ */
+struct TaskGroup{
+	ThreadPool* pool;
+	std::atomic<std::size_t> pending{0};
+	std::mutex errorLock;
+	std::exception_ptr error;
+	inline explicit TaskGroup(ThreadPool* p) : pool(p){}
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+	inline ~TaskGroup(){
+		//Tasks refer to this group, so they have to be done even when wait() was skipped by an exception
+		while(pending.load())
+			if(!pool->runPending())std::this_thread::yield();
+	}
+	template<typename F>
+	inline void run(F&& f){
+		if(!pool){
+			f();
+			return;
 		}
-		if(signum < o.signum){
-			return true;
+		pending.fetch_add(1);
+		pool->submit([this, f = std::forward<F>(f)]() mutable{
+			try{
+				f();
+			}
+			catch(...){
+				std::lock_guard<std::mutex> guard(errorLock);
+				if(!error)error = std::current_exception();
+			}
+			pending.fetch_sub(1);
+		});
+	}
+	inline void wait(){
+		while(pending.load())
+			if(!pool->runPending())std::this_thread::yield();
+		if(error)std::rethrow_exception(error);
+	}
+};
+//Runs f(begin, end) on about four ranges per thread of [0, count), or once over all of it without a pool
+template<typename F>
+inline void parallelFor(ThreadPool* pool, std::size_t count, F&& f){
+	if(!pool || count < 2){
+		f((std::size_t)0, count);
+		return;
+	}
+	std::size_t parts = std::min(count, 4 * (pool->size() + 1));
+	TaskGroup tasks(pool);
+	for(std::size_t p = 1;p < parts;p++){
+		std::size_t b = count * p / parts, e = count * (p + 1) / parts;
+		tasks.run([&f, b, e]{f(b, e);});
+	}
+	f((std::size_t)0, count / parts);
+	tasks.wait();
+}
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__) && !defined(BIGINT_NO_SIMD)
+#define BIGINT_SIMD_X86 1
+#include <immintrin.h>
+#endif
+/*
+ * Low level kernels on raw limb spans (least significant limb first).
+ * Unless stated otherwise the destination may alias a source of the same length.
+ */
+namespace mpn{
+	using limb = std::uint64_t;
+	/*
+	 * SIMD kernels for the bulk limb loops, selected at run time so that one binary still runs on hosts
+	 * without AVX2 or AVX-512. Only GCC and Clang on x86-64 get them (they need per-function target
+	 * attributes), define BIGINT_NO_SIMD to compile them out.
+	 */
+	enum class SimdLevel{none, avx2, avx512, avx512ifma};
+#ifdef BIGINT_SIMD_X86
+	inline SimdLevel detectSimdLevel(){
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx512f")){
+			if(__builtin_cpu_supports("avx512ifma"))return SimdLevel::avx512ifma;
+			return SimdLevel::avx512;
+		}
+		if(__builtin_cpu_supports("avx2"))return SimdLevel::avx2;
+		return SimdLevel::none;
+	}
+#else
+	inline SimdLevel detectSimdLevel(){return SimdLevel::none;}
+#endif
+	//Kernels used by the dispatchers below, lower it to force an older instruction set
+	inline SimdLevel simdLevel = detectSimdLevel();
+	//Spans shorter than this stay on the scalar loops, where the dispatch would cost more than it saves
+	constexpr std::size_t simdMinLimbs = 8;
+	enum class BitOp{andOp, iorOp, xorOp};
+	template<BitOp op>
+	inline limb applyBitOp(limb a, limb b){
+		return op == BitOp::andOp ? a & b : op == BitOp::iorOp ? a | b : a ^ b;
+	}
+#ifdef BIGINT_SIMD_X86
+	namespace simd{
+		template<BitOp op>
+		__attribute__((target("avx2"))) inline __m256i bitop(__m256i a, __m256i b){
+			if(op == BitOp::andOp)return _mm256_and_si256(a, b);
+			if(op == BitOp::iorOp)return _mm256_or_si256(a, b);
+			return _mm256_xor_si256(a, b);
 		}
-		const_iterator it1 = begin();
-		const_iterator it2 = o.begin();
-		if(size() > o.size()){
-			it1 += size() - o.size();
-			auto _t = begin();
-			while(_t != it1){
-				if(*_t)return true;
-				++_t;
+		template<BitOp op>
+		__attribute__((target("avx512f"))) inline __m512i bitop(__m512i a, __m512i b){
+			if(op == BitOp::andOp)return _mm512_and_si512(a, b);
+			if(op == BitOp::iorOp)return _mm512_or_si512(a, b);
+			return _mm512_xor_si512(a, b);
+		}
+		template<BitOp op>
+		__attribute__((target("avx2"))) inline void bitop_n_avx2(limb* r, const limb* a, const limb* b, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 4 <= n;i += 4){
+				__m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+				__m256i y = _mm256_loadu_si256((const __m256i*)(b + i));
+				_mm256_storeu_si256((__m256i*)(r + i), bitop<op>(x, y));
 			}
+			for(;i < n;i++)r[i] = applyBitOp<op>(a[i], b[i]);
 		}
-		else if(size() < o.size()){
-			it2 += o.size() - size();
-			auto _t = o.begin();
-			while(_t != it2){
-				if(*_t)return false;
-				++_t;
+		template<BitOp op>
+		__attribute__((target("avx512f"))) inline void bitop_n_avx512(limb* r, const limb* a, const limb* b, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 8 <= n;i += 8)
+				_mm512_storeu_si512(r + i, bitop<op>(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)));
+			if(i < n){
+				__mmask8 m = (__mmask8)((1u << (n - i)) - 1);
+				__m512i x = _mm512_maskz_loadu_epi64(m, a + i);
+				__m512i y = _mm512_maskz_loadu_epi64(m, b + i);
+				_mm512_mask_storeu_epi64(r + i, m, bitop<op>(x, y));
 			}
 		}
-		while(it1 != end() && it2 != o.end()){
-			if(*(it1) < *(it2))return true;
-			if(*(it1) > *(it2))return false;
-			++it1;++it2;
+		__attribute__((target("avx2"))) inline void zero_avx2(limb* r, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 4 <= n;i += 4)_mm256_storeu_si256((__m256i*)(r + i), _mm256_setzero_si256());
+			for(;i < n;i++)r[i] = 0;
 		}
-		return true;
-	}
-	inline bool operator>=(const BigInt& o)const{
-		if(signum < o.signum){
-			return false;
+		__attribute__((target("avx512f"))) inline void zero_avx512(limb* r, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 8 <= n;i += 8)_mm512_storeu_si512(r + i, _mm512_setzero_si512());
+			if(i < n)_mm512_mask_storeu_epi64(r + i, (__mmask8)((1u << (n - i)) - 1), _mm512_setzero_si512());
+		}
+		//Both scans fold 16 limbs per test and stop at the first block that settles the answer
+		__attribute__((target("avx2"))) inline bool isZero_avx2(const limb* a, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 16 <= n;i += 16){
+				__m256i x = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(a + i + 4)));
+				__m256i y = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(a + i + 8)), _mm256_loadu_si256((const __m256i*)(a + i + 12)));
+				x = _mm256_or_si256(x, y);
+				if(!_mm256_testz_si256(x, x))return false;
+			}
+			for(;i < n;i++)
+				if(a[i])return false;
+			return true;
 		}
-		if(signum > o.signum){
+		__attribute__((target("avx512f"))) inline bool isZero_avx512(const limb* a, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 16 <= n;i += 16){
+				__m512i x = _mm512_or_si512(_mm512_loadu_si512(a + i), _mm512_loadu_si512(a + i + 8));
+				if(_mm512_test_epi64_mask(x, x))return false;
+			}
+			for(;i + 8 <= n;i += 8){
+				__m512i x = _mm512_loadu_si512(a + i);
+				if(_mm512_test_epi64_mask(x, x))return false;
+			}
+			if(i < n){
+				__m512i x = _mm512_maskz_loadu_epi64((__mmask8)((1u << (n - i)) - 1), a + i);
+				if(_mm512_test_epi64_mask(x, x))return false;
+			}
 			return true;
 		}
-		const_iterator it1 = begin();
-		const_iterator it2 = o.begin();
-		if(size() > o.size()){
-			it1 += size() - o.size();
-			auto _t = begin();
-			while(_t != it1){
-				if(*_t)return true;
-				++_t;
+		__attribute__((target("avx2"))) inline bool equal_avx2(const limb* a, const limb* b, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 8 <= n;i += 8){
+				__m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+				__m256i y = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i + 4)), _mm256_loadu_si256((const __m256i*)(b + i + 4)));
+				x = _mm256_or_si256(x, y);
+				if(!_mm256_testz_si256(x, x))return false;
 			}
+			for(;i < n;i++)
+				if(a[i] != b[i])return false;
+			return true;
 		}
-		else if(size() < o.size()){
-			it2 += o.size() - size();
-			auto _t = o.begin();
-			while(_t != it2){
-				if(*_t)return false;
-				++_t;
+		__attribute__((target("avx512f"))) inline bool equal_avx512(const limb* a, const limb* b, std::size_t n){
+			std::size_t i = 0;
+			for(;i + 8 <= n;i += 8)
+				if(_mm512_cmpneq_epi64_mask(_mm512_loadu_si512(a + i), _mm512_loadu_si512(b + i)))return false;
+			if(i < n){
+				__mmask8 m = (__mmask8)((1u << (n - i)) - 1);
+				if(_mm512_mask_cmpneq_epi64_mask(m, _mm512_maskz_loadu_epi64(m, a + i), _mm512_maskz_loadu_epi64(m, b + i)))return false;
 			}
+			return true;
 		}
-		while(it1 != end() && it2 != o.end()){
-			if(*(it1) > *(it2))return true;
-			if(*(it1) < *(it2))return false;
-			++it1;++it2;
+		/*
+		 * Limb shifts, r[i] = a[i] << cnt | a[i - 1] >> (64 - cnt) and the mirror image. Every block is loaded
+		 * before it is stored and lshift walks down while rshift walks up, so the same overlaps as the scalar
+		 * kernels are allowed. They return where the scalar loop has to take over, which also covers the
+		 * limb that needs the bits shifted out.
+		 * The AVX-512 versions use the zero masked shifts because GCC 12 flags the undefined source of the plain ones.
+		 */
+		__attribute__((target("avx2"))) inline std::size_t lshift_avx2(limb* r, const limb* a, std::size_t n, unsigned int cnt){
+			__m128i sl = _mm_cvtsi32_si128((int)cnt), sr = _mm_cvtsi32_si128((int)(64 - cnt));
+			std::size_t i = n;
+			for(;i >= 5;i -= 4){
+				__m256i hi = _mm256_loadu_si256((const __m256i*)(a + i - 4));
+				__m256i lo = _mm256_loadu_si256((const __m256i*)(a + i - 5));
+				_mm256_storeu_si256((__m256i*)(r + i - 4), _mm256_or_si256(_mm256_sll_epi64(hi, sl), _mm256_srl_epi64(lo, sr)));
+			}
+			return i;
 		}
-		return true;
-	}
-	inline bool operator==(const BigInt& o)const{
-		if(signum < o.signum){
-			return false;
-		}
-		if(signum > o.signum){
-			return false;
-		}
-		const_iterator it1 = begin();
-		const_iterator it2 = o.begin();
-		if(size() > o.size()){
-			it1 += size() - o.size();
-			auto _t = begin();
-			while(_t != it1){
-				if(*_t)return false;
-				++_t;
+		__attribute__((target("avx512f"))) inline std::size_t lshift_avx512(limb* r, const limb* a, std::size_t n, unsigned int cnt){
+			__m512i sl = _mm512_set1_epi64(cnt), sr = _mm512_set1_epi64(64 - cnt);
+			std::size_t i = n;
+			for(;i >= 9;i -= 8){
+				__m512i hi = _mm512_loadu_si512(a + i - 8);
+				__m512i lo = _mm512_loadu_si512(a + i - 9);
+				_mm512_storeu_si512(r + i - 8, _mm512_or_si512(_mm512_maskz_sllv_epi64(0xff, hi, sl), _mm512_maskz_srlv_epi64(0xff, lo, sr)));
+			}
+			return i;
+		}
+		__attribute__((target("avx2"))) inline std::size_t rshift_avx2(limb* r, const limb* a, std::size_t n, unsigned int cnt){
+			__m128i sr = _mm_cvtsi32_si128((int)cnt), sl = _mm_cvtsi32_si128((int)(64 - cnt));
+			std::size_t i = 0;
+			for(;i + 5 <= n;i += 4){
+				__m256i lo = _mm256_loadu_si256((const __m256i*)(a + i));
+				__m256i hi = _mm256_loadu_si256((const __m256i*)(a + i + 1));
+				_mm256_storeu_si256((__m256i*)(r + i), _mm256_or_si256(_mm256_srl_epi64(lo, sr), _mm256_sll_epi64(hi, sl)));
 			}
+			return i;
 		}
-		else if(size() < o.size()){
-			it2 += o.size() - size();
-			auto _t = o.begin();
-			while(_t != it2){
-				if(*_t)return false;
-				++_t;
+		__attribute__((target("avx512f"))) inline std::size_t rshift_avx512(limb* r, const limb* a, std::size_t n, unsigned int cnt){
+			__m512i sr = _mm512_set1_epi64(cnt), sl = _mm512_set1_epi64(64 - cnt);
+			std::size_t i = 0;
+			for(;i + 9 <= n;i += 8){
+				__m512i lo = _mm512_loadu_si512(a + i);
+				__m512i hi = _mm512_loadu_si512(a + i + 1);
+				_mm512_storeu_si512(r + i, _mm512_or_si512(_mm512_maskz_srlv_epi64(0xff, lo, sr), _mm512_maskz_sllv_epi64(0xff, hi, sl)));
 			}
+			return i;
 		}
-		while(it1 != end() && it2 != o.end()){
-			if(*(it1) != *(it2))return false;
-			++it1;++it2;
+	}
+#endif
+	inline void zero(limb* r, std::size_t n){
+#ifdef BIGINT_SIMD_X86
+		if(n >= simdMinLimbs && simdLevel >= SimdLevel::avx2){
+			if(simdLevel >= SimdLevel::avx512)simd::zero_avx512(r, n);
+			else simd::zero_avx2(r, n);
+			return;
 		}
+#endif
+		for(std::size_t i = 0;i < n;i++)r[i] = 0;
+	}
+	inline void copy(limb* r, const limb* a, std::size_t n){
+		if(n && r != a)std::memmove(r, a, n * sizeof(limb));
+	}
+	inline bool isZero(const limb* a, std::size_t n){
+#ifdef BIGINT_SIMD_X86
+		if(n >= simdMinLimbs && simdLevel >= SimdLevel::avx2)
+			return simdLevel >= SimdLevel::avx512 ? simd::isZero_avx512(a, n) : simd::isZero_avx2(a, n);
+#endif
+		for(std::size_t i = 0;i < n;i++)
+			if(a[i])return false;
+		return true;
+	}
+	//Whether two spans of equal length hold the same limbs
+	inline bool equal_n(const limb* a, const limb* b, std::size_t n){
+#ifdef BIGINT_SIMD_X86
+		if(n >= simdMinLimbs && simdLevel >= SimdLevel::avx2)
+			return simdLevel >= SimdLevel::avx512 ? simd::equal_avx512(a, b, n) : simd::equal_avx2(a, b, n);
+#endif
+		for(std::size_t i = 0;i < n;i++)
+			if(a[i] != b[i])return false;
 		return true;
 	}
-	inline bool operator==(uint64_t o){
-		return size() == 1 && *rbegin() == o;
+	inline std::size_t normalizedSize(const limb* a, std::size_t n){
+		while(n > 0 && a[n - 1] == 0)--n;
+		return n;
 	}
-	inline bool isZero()const{
-		for(auto it = data.begin();it != data.end();it++){
-			if(*it)return false;
+	inline std::size_t bitLength(const limb* a, std::size_t n){
+		n = normalizedSize(a, n);
+		if(n == 0)return 0;
+		return n * 64 - _leading_zeros(a[n - 1]);
+	}
+	//Compares two spans of equal length
+	inline int cmp_n(const limb* a, const limb* b, std::size_t n){
+		while(n-- > 0){
+			if(a[n] != b[n])return a[n] < b[n] ? -1 : 1;
 		}
-		return true;
+		return 0;
 	}
-	inline void setZero(){
-		for(auto it = begin();it != end();it++)*it = 0;
+	//Compares two spans of any length, ignoring zero limbs on top
+	inline int cmp(const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		an = normalizedSize(a, an);
+		bn = normalizedSize(b, bn);
+		if(an != bn)return an < bn ? -1 : 1;
+		return cmp_n(a, b, an);
 	}
-	
-	inline BigInt& trim(){
-		while(data[0] == 0 && data.size() > 1){
-			data.pop_front();
+	//r = a + b, returns the carry out
+	inline limb add_n(limb* r, const limb* a, const limb* b, std::size_t n){
+		unsigned char c = 0;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long s;
+			c = _addc_u64(c, a[i], b[i], &s);
+			r[i] = s;
 		}
-		return *this;
+		return c;
 	}
-	
-	inline BigInt div(uint64_t d)const{
-		BigInt ret = *this;
-		lui carry = 0;
-		for(auto it = ret.data.begin();it != ret.data.end();it++){
-			lui temp = (lui)*it;
-			temp += carry;
-			carry = temp % d;
-			*it = (uint64_t)(temp / d);
-			carry <<= 64;
+	//r = a + b, returns the carry out
+	inline limb add_1(limb* r, const limb* a, std::size_t n, limb b){
+		std::size_t i = 0;
+		for(;i < n && b;i++){
+			unsigned long long s;
+			b = _adc_u64(a[i], b, &s);
+			r[i] = s;
 		}
-		return ret;
+		if(r != a)
+			for(;i < n;i++)r[i] = a[i];
+		return b;
 	}
-	inline BigInt& div(uint64_t d){
-		lui carry = 0;
-		for(auto it = data.begin();it != data.end();it++){
-			lui temp = (lui)*it;
-			temp += carry;
-			carry = temp % d;
-			*it = (uint64_t)(temp / d);
-			carry <<= 64;
+	//r = a + b where an >= bn and r has room for an limbs, returns the carry out
+	inline limb add(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		assert(an >= bn);
+		limb c = add_n(r, a, b, bn);
+		return add_1(r + bn, a + bn, an - bn, c);
+	}
+	//r = a - b, returns the borrow out
+	inline limb sub_n(limb* r, const limb* a, const limb* b, std::size_t n){
+		unsigned char c = 0;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long s;
+			c = _subb_u64(c, a[i], b[i], &s);
+			r[i] = s;
 		}
-		return *this;
+		return c;
 	}
-	inline uint64_t mod(uint64_t m)const{
-		lui carry = 0;
-		for(auto it = data.begin();it != data.end();it++){
-			carry <<= 64;
-			carry = (*it + carry) % m;
+	//r = a - b, returns the borrow out
+	inline limb sub_1(limb* r, const limb* a, std::size_t n, limb b){
+		std::size_t i = 0;
+		for(;i < n && b;i++){
+			unsigned long long s;
+			b = _sbc_u64(a[i], b, &s);
+			r[i] = s;
 		}
-		return carry;
+		if(r != a)
+			for(;i < n;i++)r[i] = a[i];
+		return b;
 	}
-	
-	inline BigInt& bitshiftLeft(int c){
-		if(c < 0)return bitshiftRight(-c);
-		unsigned int sh = c % 64;
-		unsigned int jmp = c / 64;
-		if((unsigned int)jmp >= size()){std::fill(begin(),end(),0);return *this;}
-		auto it1 = begin(); 
-		auto it2 = it1 + jmp;
-		auto beforeEnd = end() - 1;
-		while(it2 != beforeEnd){
-			*it1 = (*it2 << sh);
-			if(sh)
-			*it1 |= (*(it2 + 1) >> (64 - sh));
-			++it1;++it2;
-		}
-		*it1 = (*it2 << sh);
-		++it1;++it2;
-		while(it1 != end()){
-			*it1 = 0;
-			++it1;
+	//r = a - b where an >= bn, returns the borrow out
+	inline limb sub(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		assert(an >= bn);
+		limb c = sub_n(r, a, b, bn);
+		return sub_1(r + bn, a + bn, an - bn, c);
+	}
+	//r = a * b, returns the high limb
+	inline limb mul_1(limb* r, const limb* a, std::size_t n, limb b){
+		unsigned long long carry = 0;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long hi;
+			unsigned long long lo = mulx_u64(a[i], b, &hi);
+			hi += _adc_u64(lo, carry, &lo);
+			r[i] = lo;
+			carry = hi;
 		}
-		return *this;
+		return carry;
 	}
-	
-	inline BigInt& bitshiftLeft_expand(int c){
-		if(c < 0)return bitshiftRight(-c);
-		unsigned int sh = c % 64;
-		unsigned int jmp = c / 64;
-		int insert_count = std::max((size_t)0, jmp - bitscanForward() / 64 + 1);
-		while(insert_count --> 0)
-			data.push_front(0);
-		auto it1 = begin(); 
-		auto it2 = it1 + jmp;
-		auto beforeEnd = end() - 1;
-		while(it2 != beforeEnd){
-			*it1 = (*it2 << sh);
-			if(sh)
-			*it1 |= (*(it2 + 1) >> (64 - sh));
-			++it1;++it2;
-		}
-		*it1 = (*it2 << sh);
-		++it1;++it2;
-		while(it1 != end()){
-			*it1 = 0;
-			++it1;
+	//r += a * b, returns the high limb
+	inline limb addmul_1(limb* r, const limb* a, std::size_t n, limb b){
+		unsigned long long carry = 0;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long hi;
+			unsigned long long lo = mulx_u64(a[i], b, &hi);
+			hi += _adc_u64(lo, carry, &lo);
+			hi += _adc_u64(r[i], lo, &lo);
+			r[i] = lo;
+			carry = hi;
 		}
-		return *this;
+		return carry;
 	}
-	
-	inline BigInt& bitshiftRight(int c){
-		if(c < 0)return bitshiftLeft(-c);
-		unsigned int sh = c % 64;
-		unsigned int jmp = c / 64;
-		if((unsigned int)jmp >= size()){std::fill(begin(),end(),0);return *this;}
-		auto it1 = rbegin(); 
-		auto it2 = it1 + jmp;
-		auto beforeRend = rend() - 1;
-		while(it2 != beforeRend){
-			*it1 = (*it2 >> sh);
-			if(sh)
-			*it1 |= (*(it2 + 1) << (64 - sh));
-			++it1;++it2;
-		}
-		*it1 = (*it2 >> sh);
-		++it1;++it2;
-		while(it1 != rend()){
-			*it1 = 0;
-			++it1;
+	//r -= a * b, returns the high limb that still has to be subtracted
+	inline limb submul_1(limb* r, const limb* a, std::size_t n, limb b){
+		unsigned long long carry = 0;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long hi;
+			unsigned long long lo = mulx_u64(a[i], b, &hi);
+			hi += _adc_u64(lo, carry, &lo);
+			hi += _sbc_u64(r[i], lo, &lo);
+			r[i] = lo;
+			carry = hi;
 		}
-		return *this;
+		return carry;
 	}
-	inline BigInt operator<<(int c)const{
-		BigInt ret = *this;
-		ret.bitshiftLeft(c);
-		return ret;
+#ifdef BIGINT_SIMD_X86
+	namespace simd{
+		inline void mul_basecase_ifma(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
 	}
-	
-	inline BigInt operator>>(int c)const{
-		BigInt ret = *this;
-		ret.bitshiftRight(c);
-		return ret;
+#endif
+	/*
+	 * Smaller operand size (in limbs) from which mul_basecase and sqr_basecase run on the AVX-512 IFMA units,
+	 * and the size above which their 64 bit column sums could overflow. Squaring has half the products to
+	 * begin with, so it switches later.
+	 */
+	inline std::size_t ifmaMinLimbs = 16;
+	inline std::size_t ifmaSqrMinLimbs = 24;
+	constexpr std::size_t ifmaMaxLimbs = 1024;
+	//r = a * b, r has an + bn limbs and must not overlap a or b
+	inline void mul_basecase(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+#ifdef BIGINT_SIMD_X86
+		std::size_t small = std::min(an, bn);
+		if(small >= ifmaMinLimbs && small <= ifmaMaxLimbs && simdLevel >= SimdLevel::avx512ifma)
+			return simd::mul_basecase_ifma(r, a, an, b, bn);
+#endif
+		r[an] = mul_1(r, a, an, b[0]);
+		for(std::size_t i = 1;i < bn;i++)
+			r[an + i] = addmul_1(r + i, a, an, b[i]);
 	}
-	
-	inline BigInt& operator<<=(int c){
-		return bitshiftLeft(c);
+	//r = a << cnt with 0 < cnt < 64, returns the bits shifted out; r may be at or above a
+	inline limb lshift(limb* r, const limb* a, std::size_t n, unsigned int cnt){
+		assert(cnt > 0 && cnt < 64);
+		limb out = a[n - 1] >> (64 - cnt);
+		std::size_t top = n;
+#ifdef BIGINT_SIMD_X86
+		if(n >= simdMinLimbs && simdLevel >= SimdLevel::avx2)
+			top = simdLevel >= SimdLevel::avx512 ? simd::lshift_avx512(r, a, n, cnt) : simd::lshift_avx2(r, a, n, cnt);
+#endif
+		for(std::size_t i = top - 1;i > 0;i--)
+			r[i] = (a[i] << cnt) | (a[i - 1] >> (64 - cnt));
+		r[0] = a[0] << cnt;
+		return out;
 	}
-	
-	inline BigInt& operator>>=(int c){
-		return bitshiftRight(c);
+	//r = a >> cnt with 0 < cnt < 64, returns the bits shifted out (in the high bits); r may be at or below a
+	inline limb rshift(limb* r, const limb* a, std::size_t n, unsigned int cnt){
+		assert(cnt > 0 && cnt < 64);
+		limb out = a[0] << (64 - cnt);
+		std::size_t i = 0;
+#ifdef BIGINT_SIMD_X86
+		if(n >= simdMinLimbs && simdLevel >= SimdLevel::avx2)
+			i = simdLevel >= SimdLevel::avx512 ? simd::rshift_avx512(r, a, n, cnt) : simd::rshift_avx2(r, a, n, cnt);
+#endif
+		for(;i + 1 < n;i++)
+			r[i] = (a[i] >> cnt) | (a[i + 1] << (64 - cnt));
+		r[n - 1] = a[n - 1] >> cnt;
+		return out;
 	}
-	
-	inline BigInt& operator&=(const BigInt& o){
-		auto it1 = rbegin();
-		auto it2 = o.rbegin();
-		while(it1 != rend() && it2 != o.rend())
-			*(it1++) &= *(it2++);
-		return *this;
+	//q = a / d, returns a % d
+	inline limb divrem_1(limb* q, const limb* a, std::size_t n, limb d){
+		using lui = ::uint_128bit;
+		lui rem = 0;
+		for(std::size_t i = n;i-- > 0;){
+			lui cur = (rem << 64) | a[i];
+			q[i] = (limb)(cur / d);
+			rem = cur % d;
+		}
+		return (limb)rem;
 	}
-	inline BigInt& operator|=(const BigInt& o){
-		auto it1 = rbegin();
-		auto it2 = o.rbegin();
-		while(it1 != rend() && it2 != o.rend())
-			*(it1++) |= *(it2++);
-		return *this;
+	inline limb mod_1(const limb* a, std::size_t n, limb d){
+		using lui = ::uint_128bit;
+		lui rem = 0;
+		for(std::size_t i = n;i-- > 0;)
+			rem = ((rem << 64) | a[i]) % d;
+		return (limb)rem;
 	}
-	inline BigInt& operator^=(const BigInt& o){
-		auto it1 = rbegin();
-		auto it2 = o.rbegin();
-		while(it1 != rend() && it2 != o.rend())
-			*(it1++) ^= *(it2++);
-		return *this;
+	/*
+	 * Single limb divisor with its reciprocal precomputed (Moller and Granlund, "Improved division by invariant
+	 * integers"): d is shifted left until its top bit is set and v = floor((2^128 - 1) / d) - 2^64, after which every
+	 * two-by-one limb division costs a multiplication and a few adds instead of a 128 bit hardware divide.
+	 */
+	struct LimbDivisor{
+		limb d;
+		unsigned int shift;
+		limb v;
+		//Division by 1, normalized like every other divisor
+		inline LimbDivisor() : d((limb)1 << 63), shift(63), v(~(limb)0){}
+		inline explicit LimbDivisor(limb divisor){
+			assert(divisor);
+			shift = _leading_zeros(divisor);
+			d = divisor << shift;
+			v = (limb)(((::uint_128bit)~d << 64 | ~(limb)0) / d);
+		}
+		inline limb divisor()const{return d >> shift;}
+		//q = (u1 2^64 + u0) / d and r the remainder for the normalized d and u1 < d
+		inline limb divrem(limb& r, limb u1, limb u0)const{
+			using lui = ::uint_128bit;
+			lui p = (lui)v * u1 + ((lui)u1 << 64 | u0);
+			limb q = (limb)(p >> 64) + 1;
+			r = u0 - q * d;
+			//The first correction is taken about half the time, so it is done with a mask rather than a branch
+			limb mask = 0 - (limb)(r > (limb)p);
+			q += mask;
+			r += mask & d;
+			if(r >= d){
+				++q;
+				r -= d;
+			}
+			return q;
+		}
+	};
+	//q = a / d, returns a % d
+	inline limb divrem_1(limb* q, const limb* a, std::size_t n, const LimbDivisor& d){
+		unsigned int s = d.shift;
+		limb r = 0;
+		if(!s){
+			for(std::size_t i = n;i-- > 0;)q[i] = d.divrem(r, r, a[i]);
+			return r;
+		}
+		r = a[n - 1] >> (64 - s);
+		for(std::size_t i = n - 1;i > 0;i--)q[i] = d.divrem(r, r, a[i] << s | a[i - 1] >> (64 - s));
+		q[0] = d.divrem(r, r, a[0] << s);
+		return r >> s;
 	}
-	inline BigInt operator&(const BigInt& o)const{
-		BigInt ret(*this);
-		ret &= o;
-		return ret;
+	inline limb mod_1(const limb* a, std::size_t n, const LimbDivisor& d){
+		unsigned int s = d.shift;
+		limb r = 0;
+		if(!s){
+			for(std::size_t i = n;i-- > 0;)d.divrem(r, r, a[i]);
+			return r;
+		}
+		r = a[n - 1] >> (64 - s);
+		for(std::size_t i = n - 1;i > 0;i--)d.divrem(r, r, a[i] << s | a[i - 1] >> (64 - s));
+		d.divrem(r, r, a[0] << s);
+		return r >> s;
 	}
-	inline BigInt operator|(const BigInt& o)const{
-		BigInt ret(*this);
-		ret |= o;
-		return ret;
+	//Modular inverse of an odd limb modulo 2^64
+	inline limb binvert(limb d){
+		assert(d & 1);
+		limb inv = d;
+		for(int i = 0;i < 5;i++)inv *= 2 - d * inv;
+		return inv;
 	}
-	inline BigInt operator^(const BigInt& o)const{
-		BigInt ret(*this);
-		ret ^= o;
-		return ret;
+	//r = a / d for an odd d that divides a exactly (a is taken modulo 2^(64n), so two's complement values work too)
+	inline void divexact_1(limb* r, const limb* a, std::size_t n, limb d){
+		limb inv = binvert(d);
+		unsigned long long c = 0;
+		for(std::size_t i = 0;i < n;i++){
+			limb s = a[i];
+			limb l = s - c;
+			c = l > s;
+			l *= inv;
+			r[i] = l;
+			unsigned long long h;
+			mulx_u64(l, d, &h);
+			c += h;
+		}
 	}
-	inline BigInt& cut(size_t chunks){
-		while(size() > chunks)data.pop_front();
-		return *this;
+	//r = -a modulo 2^(64n)
+	inline void neg(limb* r, const limb* a, std::size_t n){
+		unsigned char c = 1;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long s;
+			c = _addc_u64(c, ~a[i], 0, &s);
+			r[i] = s;
+		}
 	}
-	inline int bitDifference(const BigInt& o){
-		int pos1(0),pos2(0);
-		auto it1 = begin();
-		auto it2 = o.begin();
-		bool bitfound = false;
-		while(it1 != end()){
-			if(*it1 == 0)
-				pos1 += 64;
-			else{
-				pos1 += _leading_zeros(*it1);
-				bitfound = true;
-				break;
+	template<BitOp op>
+	inline void bitop_n(limb* r, const limb* a, const limb* b, std::size_t n){
+#ifdef BIGINT_SIMD_X86
+		if(n >= simdMinLimbs && simdLevel >= SimdLevel::avx2){
+			if(simdLevel >= SimdLevel::avx512)simd::bitop_n_avx512<op>(r, a, b, n);
+			else simd::bitop_n_avx2<op>(r, a, b, n);
+			return;
+		}
+#endif
+		for(std::size_t i = 0;i < n;i++)r[i] = applyBitOp<op>(a[i], b[i]);
+	}
+	//r = a & b, r = a | b and r = a ^ b
+	inline void and_n(limb* r, const limb* a, const limb* b, std::size_t n){bitop_n<BitOp::andOp>(r, a, b, n);}
+	inline void ior_n(limb* r, const limb* a, const limb* b, std::size_t n){bitop_n<BitOp::iorOp>(r, a, b, n);}
+	inline void xor_n(limb* r, const limb* a, const limb* b, std::size_t n){bitop_n<BitOp::xorOp>(r, a, b, n);}
+	//Scratch limbs for the duration of a kernel call, from the thread's ScratchArena or scratchLimbAllocator() if they are very many
+	struct TempLimbs{
+		limb* p;
+		ScratchArena* arena;
+		ScratchArena::Mark mark;
+		LimbAllocator* alloc = nullptr;
+		std::size_t n;
+		inline explicit TempLimbs(std::size_t count) : arena(&ScratchArena::current()), n(count){
+			if(n > ScratchArena::maxLimbs){
+				arena = nullptr;
+				alloc = scratchLimbAllocator();
+				p = alloc->allocate(std::max<std::size_t>(1, n));
+				return;
 			}
-			++it1;
+			mark = arena->mark();
+			p = arena->push(std::max<std::size_t>(1, n));
 		}
-		if(!bitfound)pos1 = size() * 64;
-		bitfound = false;
-		while(it2 != o.end()){
-			if(*it2 == 0)
-				pos2 += 64;
-			else{
-				pos2 += _leading_zeros(*it2);
-				bitfound = true;
-				break;
+		inline ~TempLimbs(){
+			if(arena)arena->release(mark);
+			else alloc->deallocate(p, std::max<std::size_t>(1, n));
+		}
+		TempLimbs(const TempLimbs&) = delete;
+		TempLimbs& operator=(const TempLimbs&) = delete;
+		inline limb* get(){return p;}
+		inline operator limb*(){return p;}
+	};
+#ifdef BIGINT_SIMD_X86
+	namespace simd{
+		constexpr limb mask52 = ((limb)1 << 52) - 1;
+		//Splits the n limbs of a into m digits of 52 bits
+		inline void toRadix52(limb* d, const limb* a, std::size_t n, std::size_t m){
+			for(std::size_t k = 0;k < m;k++){
+				std::size_t bit = 52 * k, w = bit / 64;
+				unsigned int sh = bit % 64;
+				limb v = a[w] >> sh;
+				if(sh > 12 && w + 1 < n)v |= a[w + 1] << (64 - sh);
+				d[k] = v & mask52;
 			}
-			++it2;
 		}
-		if(!bitfound)pos2 = o.size() * 64;
-		int sizediff = ((signed int)size()) - ((signed int)o.size());
-		return pos2 - pos1 + sizediff * 64;
-	}
-	inline BigInt& chunkshiftLeft(int c){
-		if(c < 0)return chunkshiftRight(-c);
-		if((unsigned int)c >= size()){std::fill(begin(),end(),0);return *this;}
-		auto it1 = data.begin(); 
-		auto it2 = it1 + c;
-		while(it2 != data.end())*(it1++) = *(it2++);
-		while(it1 != data.end())*(it1++) = 0;
-		return *this;
-	}
-	
-	inline BigInt& chunkshiftRight(int c){
-		if(c < 0)return chunkshiftLeft(-c);
-		if((unsigned int)c >= size()){std::fill(begin(),end(),0);return *this;}
-		auto it1 = data.rbegin(); 
-		auto it2 = it1 + c;
-		while(it2 != data.rend())*(it1++) = *(it2++);
-		while(it1 != data.rend())*(it1++) = 0;
-		return *this;
+		//Packs 52 bit digits back into n limbs, d is read up to two digits past the last one it covers
+		inline void fromRadix52(limb* r, std::size_t n, const limb* d){
+			for(std::size_t w = 0;w < n;w++){
+				std::size_t bit = 64 * w, k = bit / 52;
+				unsigned int sh = bit % 52;
+				limb v = (d[k] >> sh) | (d[k + 1] << (52 - sh));
+				if(sh > 40)v |= d[k + 2] << (104 - sh);
+				r[w] = v;
+			}
+		}
+		/*
+		 * Product scanning in radix 2^52: each block of 8 result columns keeps its low and high halves in two
+		 * registers and accumulates a[i] * b[k - i .. k - i + 7] with vpmadd52luq / vpmadd52huq. b is padded
+		 * with zero digits on both sides so that every load stays in bounds.
+		 */
+		__attribute__((target("avx512f,avx512ifma")))
+		inline void mul_basecase_ifma(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+			std::size_t ma = (64 * an + 51) / 52, mb = (64 * bn + 51) / 52;
+			std::size_t cols = (ma + mb + 8) & ~(std::size_t)7;
+			TempLimbs tmp(ma + mb + 16 + 2 * cols + 2);
+			limb* ad = tmp;
+			limb* bp = ad + ma;
+			limb* lo = bp + mb + 16;
+			limb* hi = lo + cols + 2;
+			toRadix52(ad, a, an, ma);
+			std::fill(bp, bp + 8, 0);
+			toRadix52(bp + 8, b, bn, mb);
+			std::fill(bp + 8 + mb, bp + mb + 16, 0);
+			for(std::size_t k = 0;k < cols;k += 8){
+				__m512i accLo = _mm512_setzero_si512(), accHi = _mm512_setzero_si512();
+				std::size_t first = k + 1 > mb ? k + 1 - mb : 0;
+				std::size_t last = std::min(ma, k + 8);
+				for(std::size_t i = first;i < last;i++){
+					__m512i x = _mm512_set1_epi64((long long)ad[i]);
+					__m512i y = _mm512_loadu_si512(bp + 8 + k - i);
+					accLo = _mm512_madd52lo_epu64(accLo, x, y);
+					accHi = _mm512_madd52hi_epu64(accHi, x, y);
+				}
+				_mm512_storeu_si512(lo + k, accLo);
+				_mm512_storeu_si512(hi + k, accHi);
+			}
+			//The high half of column k belongs to column k + 1
+			limb c = 0;
+			for(std::size_t k = 0;k < cols;k++){
+				limb v = lo[k] + (k ? hi[k - 1] : 0) + c;
+				lo[k] = v & mask52;
+				c = v >> 52;
+			}
+			lo[cols] = lo[cols + 1] = 0;
+			fromRadix52(r, an + bn, lo);
+		}
+		/*
+		 * Eight independent Montgomery products r = a b / 2^(52k) mod m in the lanes of one vector, digit d of
+		 * lane l is at index 8d + l and m is broadcast the same way. Digits are reduced one at a time (CIOS) into
+		 * columns that stay unnormalized until the end, which holds for k < 1024. Inputs below 2m give a
+		 * result below 2m as long as 4m < 2^(52k), so no lane needs a final subtraction.
+		 * minv is -1/m mod 2^52 and t holds 8k limbs; r may alias a or b.
+		 */
+		__attribute__((target("avx512f,avx512ifma")))
+		inline void mont_mul_ifma_x8(limb* r, const limb* a, const limb* b, const limb* m, limb minv, std::size_t k, limb* t){
+			const __m512i vminv = _mm512_set1_epi64((long long)minv);
+			const __m512i zero = _mm512_setzero_si512();
+			for(std::size_t j = 0;j < k;j++)_mm512_storeu_si512(t + 8 * j, zero);
+			for(std::size_t i = 0;i < k;i++){
+				__m512i bi = _mm512_loadu_si512(b + 8 * i);
+				__m512i t0 = _mm512_madd52lo_epu64(_mm512_loadu_si512(t), _mm512_loadu_si512(a), bi);
+				__m512i q = _mm512_madd52lo_epu64(zero, t0, vminv);
+				t0 = _mm512_madd52lo_epu64(t0, _mm512_loadu_si512(m), q);
+				//The low 52 bits of column 0 are zero now, the columns move down by one
+				__m512i carry = _mm512_maskz_srli_epi64(0xff, t0, 52);
+				for(std::size_t j = 1;j < k;j++){
+					__m512i tj = _mm512_loadu_si512(t + 8 * j);
+					__m512i aj = _mm512_loadu_si512(a + 8 * j), ap = _mm512_loadu_si512(a + 8 * (j - 1));
+					__m512i mj = _mm512_loadu_si512(m + 8 * j), mp = _mm512_loadu_si512(m + 8 * (j - 1));
+					tj = _mm512_madd52lo_epu64(tj, aj, bi);
+					tj = _mm512_madd52lo_epu64(tj, mj, q);
+					tj = _mm512_madd52hi_epu64(tj, ap, bi);
+					tj = _mm512_madd52hi_epu64(tj, mp, q);
+					if(j == 1)tj = _mm512_add_epi64(tj, carry);
+					_mm512_storeu_si512(t + 8 * (j - 1), tj);
+				}
+				__m512i top = _mm512_madd52hi_epu64(zero, _mm512_loadu_si512(a + 8 * (k - 1)), bi);
+				top = _mm512_madd52hi_epu64(top, _mm512_loadu_si512(m + 8 * (k - 1)), q);
+				if(k == 1)top = _mm512_add_epi64(top, carry);
+				_mm512_storeu_si512(t + 8 * (k - 1), top);
+			}
+			const __m512i mask = _mm512_set1_epi64((long long)mask52);
+			__m512i c = zero;
+			for(std::size_t j = 0;j < k;j++){
+				__m512i v = _mm512_add_epi64(_mm512_loadu_si512(t + 8 * j), c);
+				c = _mm512_maskz_srli_epi64(0xff, v, 52);
+				_mm512_storeu_si512(r + 8 * j, _mm512_and_si512(v, mask));
+			}
+		}
+		//r = entry e[l] of table in every lane l, for a table of vectors with k digits each
+		__attribute__((target("avx512f")))
+		inline void select_x8(limb* r, const limb* table, const limb* e, std::size_t k){
+			limb lanes[8];
+			for(std::size_t l = 0;l < 8;l++)lanes[l] = e[l] * 8 * k + l;
+			__m512i index = _mm512_loadu_si512(lanes);
+			for(std::size_t d = 0;d < k;d++)
+				_mm512_storeu_si512(r + 8 * d, _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xff, index, (const void*)(table + 8 * d), 8));
+		}
+	}
+#endif
+	/*
+	 * Schoolbook long division (Knuth, TAOCP vol. 2, 4.3.1, algorithm D) on a normalized divisor (top bit set).
+	 * q = u / v for un > dn >= 2, q has un - dn limbs and u is replaced by the remainder in its low dn limbs.
+	 * Returns the quotient limb above q, which is 1 exactly when the top dn limbs of u are not below v.
+	 */
+	inline limb divrem_basecase_norm(limb* q, limb* u, std::size_t un, const limb* v, std::size_t dn){
+		using lui = ::uint_128bit;
+		assert(un > dn && dn >= 2 && (v[dn - 1] >> 63));
+		limb qh = cmp_n(u + un - dn, v, dn) >= 0;
+		if(qh)sub_n(u + un - dn, u + un - dn, v, dn);
+		limb d1 = v[dn - 1], d0 = v[dn - 2];
+		for(std::size_t j = un - dn;j-- > 0;){
+			limb* uj = u + j;
+			lui num = ((lui)uj[dn] << 64) | uj[dn - 1];
+			lui qhat = num / d1;
+			lui rhat = num - qhat * d1;
+			if(qhat >> 64){
+				qhat = std::numeric_limits<limb>::max();
+				rhat = num - qhat * d1;
+			}
+			while(!(rhat >> 64) && qhat * d0 > ((rhat << 64) | uj[dn - 2])){
+				--qhat;
+				rhat += d1;
+			}
+			limb qj = (limb)qhat;
+			limb borrow = submul_1(uj, v, dn, qj);
+			if(uj[dn] < borrow){
+				//qhat was one too large, add the divisor back
+				--qj;
+				uj[dn] = uj[dn] - borrow + add_n(uj, uj, v, dn);
+			}
+			else uj[dn] -= borrow;
+			q[j] = qj;
+		}
+		return qh;
+	}
+	//q = a / d and r = a % d for an >= dn >= 2 and d[dn - 1] != 0; q has an - dn + 1 limbs, r has dn limbs
+	inline void divrem_basecase(limb* q, limb* r, const limb* a, std::size_t an, const limb* d, std::size_t dn){
+		assert(an >= dn && dn >= 2 && d[dn - 1] != 0);
+		unsigned int shift = _leading_zeros(d[dn - 1]);
+		TempLimbs tmp(an + 1 + dn);
+		limb* u = tmp;
+		limb* v = u + an + 1;
+		if(shift){
+			lshift(v, d, dn, shift);
+			u[an] = lshift(u, a, an, shift);
+		}
+		else{
+			mpn::copy(v, d, dn);
+			mpn::copy(u, a, an);
+			u[an] = 0;
+		}
+		//The extra top limb is below v[dn - 1], so no quotient limb spills over
+		limb qh = divrem_basecase_norm(q, u, an + 1, v, dn);
+		assert(!qh);
+		(void)qh;
+		if(shift)rshift(r, u, dn, shift);
+		else mpn::copy(r, u, dn);
+	}
+	/*
+	 * Operand sizes (in limbs of the smaller operand) at which mul switches to the next algorithm.
+	 * The defaults are rough crossovers on x86-64, tune them for the host if multiplication matters.
+	 * multThresholds drives mul and sqrThresholds drives sqr, whose basecase stays competitive for longer.
+	 * An IFMA basecase is several times faster, which pushes every recursive algorithm out to larger sizes.
+	 */
+	struct MultThresholds{
+		std::size_t karatsuba = 32;
+		std::size_t toom3 = 160;
+		std::size_t toom4 = 400;
+		std::size_t ntt = 10000;
+	};
+	inline MultThresholds defaultMultThresholds(bool square){
+		if(simdLevel >= SimdLevel::avx512ifma)
+			return square ? MultThresholds{128, 400, 800, 10000} : MultThresholds{96, 400, 800, 10000};
+		return square ? MultThresholds{48, 200, 480, 10000} : MultThresholds{};
+	}
+	inline MultThresholds multThresholds = defaultMultThresholds(false);
+	inline MultThresholds sqrThresholds = defaultMultThresholds(true);
+	/*
+	 * Products longer than this many limbs are formed from products of blocks of half of it, added into the
+	 * result in order, so the transforms and their scratch space never cover more. For operands in memory mapped
+	 * files it bounds the working set of a multiplication; 0 multiplies everything in one piece.
+	 */
+	inline std::size_t outOfCoreLimbs = 0;
+	/*
+	 * Operand size (in limbs of the smaller operand) from which mul, sqr and the decimal conversions split
+	 * their work across the shared thread pool. The pool has one thread less than parallelThreads() since the
+	 * caller works along, and it is only created once something reaches the threshold.
+	 */
+	inline std::size_t parallelThreshold = 4096;
+	struct ParallelState{
+		std::mutex lock;
+		std::unique_ptr<ThreadPool> pool;
+		std::atomic<std::size_t> threads{std::max(1u, std::thread::hardware_concurrency())};
+		std::atomic<ThreadPool*> current{nullptr};
+	};
+	inline ParallelState& parallelState(){
+		static ParallelState state;
+		return state;
+	}
+	inline std::size_t parallelThreads(){return parallelState().threads.load();}
+	//Sets the number of threads the parallel kernels use, 1 keeps everything serial. Not while BigInt work is running.
+	inline void setParallelThreads(std::size_t threads){
+		ParallelState& state = parallelState();
+		std::lock_guard<std::mutex> guard(state.lock);
+		state.current = nullptr;
+		state.pool.reset();
+		state.threads = std::max<std::size_t>(1, threads);
+	}
+	//The shared pool, or null when running serially
+	inline ThreadPool* parallelPool(){
+		ParallelState& state = parallelState();
+		ThreadPool* pool = state.current.load();
+		if(pool || state.threads.load() <= 1)return pool;
+		std::lock_guard<std::mutex> guard(state.lock);
+		if(!state.pool && state.threads.load() > 1){
+			state.pool.reset(new ThreadPool(state.threads.load() - 1));
+			state.current = state.pool.get();
+		}
+		return state.pool.get();
+	}
+	//The pool for an operation on n limbs, null below parallelThreshold
+	inline ThreadPool* parallelPoolFor(std::size_t n){return n >= parallelThreshold ? parallelPool() : nullptr;}
+	inline void mul(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn);
+	inline void sqr(limb* r, const limb* a, std::size_t n);
+	//r = a * b for an >= bn with bn not much smaller than an, splitting at half of a
+	inline void mul_karatsuba(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		std::size_t h = (an + 1) / 2;
+		assert(bn > h);
+		const limb* a0 = a;
+		const limb* a1 = a + h;
+		const limb* b0 = b;
+		const limb* b1 = b + h;
+		std::size_t a1n = an - h, b1n = bn - h;
+		TempLimbs tmp(6 * h + 1);
+		limb* da = tmp;
+		limb* db = da + h;
+		limb* zm = db + h;
+		limb* mid = zm + 2 * h;
+		//da = |a0 - a1|, db = |b0 - b1|
+		bool aneg = cmp(a0, h, a1, a1n) < 0;
+		if(aneg){
+			mpn::copy(da, a1, a1n);
+			mpn::zero(da + a1n, h - a1n);
+			sub_n(da, da, a0, h);
+		}
+		else sub(da, a0, h, a1, a1n);
+		bool bneg = cmp(b0, h, b1, b1n) < 0;
+		if(bneg){
+			mpn::copy(db, b1, b1n);
+			mpn::zero(db + b1n, h - b1n);
+			sub_n(db, db, b0, h);
+		}
+		else sub(db, b0, h, b1, b1n);
+		TaskGroup tasks(parallelPoolFor(bn));
+		tasks.run([&]{mul(r, a0, h, b0, h);});
+		tasks.run([&]{mul(r + 2 * h, a1, a1n, b1, b1n);});
+		mul(zm, da, h, db, h);
+		tasks.wait();
+		//mid = a0*b0 + a1*b1 -+ da*db = a0*b1 + a1*b0
+		std::size_t zn = a1n + b1n;
+		mid[2 * h] = add(mid, r, 2 * h, r + 2 * h, zn);
+		if(aneg == bneg)sub(mid, mid, 2 * h + 1, zm, 2 * h);
+		else add(mid, mid, 2 * h + 1, zm, 2 * h);
+		std::size_t rn = an + bn - h;
+		std::size_t mn = std::min(2 * h + 1, rn);
+		assert(isZero(mid + mn, 2 * h + 1 - mn));
+		add(r + h, r + h, rn, mid, mn);
+	}
+	//r = a^2, r has 2n limbs and must not overlap a
+	inline void sqr_basecase(limb* r, const limb* a, std::size_t n){
+#ifdef BIGINT_SIMD_X86
+		if(n >= ifmaSqrMinLimbs && n <= ifmaMaxLimbs && simdLevel >= SimdLevel::avx512ifma)
+			return simd::mul_basecase_ifma(r, a, n, a, n);
+#endif
+		//Cross products a[i] * a[j] for i < j, each computed once
+		r[0] = 0;
+		r[n] = n > 1 ? mul_1(r + 1, a + 1, n - 1, a[0]) : 0;
+		for(std::size_t i = 1;i + 1 < n;i++)
+			r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+		r[2 * n - 1] = 0;
+		if(n > 1)lshift(r, r, 2 * n, 1);
+		unsigned char c = 0;
+		for(std::size_t i = 0;i < n;i++){
+			unsigned long long hi, lo = mulx_u64(a[i], a[i], &hi);
+			c = _addc_u64(c, r[2 * i], lo, &lo);
+			c = _addc_u64(c, r[2 * i + 1], hi, &hi);
+			r[2 * i] = lo;
+			r[2 * i + 1] = hi;
+		}
+	}
+	//r = a^2 as a0^2 + (a0^2 + a1^2 - (a0 - a1)^2) B^h + a1^2 B^2h
+	inline void sqr_karatsuba(limb* r, const limb* a, std::size_t n){
+		std::size_t h = (n + 1) / 2;
+		const limb* a0 = a;
+		const limb* a1 = a + h;
+		std::size_t a1n = n - h;
+		TempLimbs tmp(5 * h + 1);
+		limb* da = tmp;
+		limb* zm = da + h;
+		limb* mid = zm + 2 * h;
+		if(cmp(a0, h, a1, a1n) < 0){
+			mpn::copy(da, a1, a1n);
+			mpn::zero(da + a1n, h - a1n);
+			sub_n(da, da, a0, h);
+		}
+		else sub(da, a0, h, a1, a1n);
+		TaskGroup tasks(parallelPoolFor(n));
+		tasks.run([&]{sqr(r, a0, h);});
+		tasks.run([&]{sqr(r + 2 * h, a1, a1n);});
+		sqr(zm, da, h);
+		tasks.wait();
+		mid[2 * h] = add(mid, r, 2 * h, r + 2 * h, 2 * a1n);
+		sub(mid, mid, 2 * h + 1, zm, 2 * h);
+		std::size_t rn = 2 * n - h;
+		std::size_t mn = std::min(2 * h + 1, rn);
+		assert(isZero(mid + mn, 2 * h + 1 - mn));
+		add(r + h, r + h, rn, mid, mn);
+	}
+	/*
+	 * Evaluation and interpolation data for Toom-Cook with homogeneous points (p, q).
+	 * A piece i is weighted with p^i * q^(K-1-i), and coefficient i of the product is
+	 * (sum_j interpolation[i][j] * value_j) / divisor.
+	 */
+	template<std::size_t K>
+	struct ToomScheme{
+		static constexpr std::size_t points = 2 * K - 1;
+		int evaluation[points][K];
+		int interpolation[points][points];
+		limb divisor;
+	};
+	constexpr ToomScheme<3> toom3Scheme = {
+		{{1, 0, 0}, {1, 1, 1}, {1, -1, 1}, {1, -2, 4}, {0, 0, 1}},
+		{{6, 0, 0, 0, 0}, {3, 2, -6, 1, -12}, {-6, 3, 3, 0, -6}, {-3, 1, 3, -1, 12}, {0, 0, 0, 0, 6}},
+		6
+	};
+	constexpr ToomScheme<4> toom4Scheme = {
+		{{1, 0, 0, 0}, {1, 1, 1, 1}, {1, -1, 1, -1}, {1, 2, 4, 8}, {1, -2, 4, -8}, {8, 4, 2, 1}, {0, 0, 0, 1}},
+		{{360, 0, 0, 0, 0, 0, 0},
+		 {-720, -240, -80, 10, 6, 16, -720},
+		 {-450, 240, 240, -15, -15, 0, 1440},
+		 {900, 540, -140, -20, 0, -20, 900},
+		 {90, -60, -60, 15, 15, 0, -1800},
+		 {-180, -120, 40, 10, -6, 4, -180},
+		 {0, 0, 0, 0, 0, 0, 360}},
+		360
+	};
+	//acc += a * m modulo 2^(64 n) for a signed factor m, a has an <= n limbs
+	inline void addmul_signed(limb* acc, std::size_t n, const limb* a, std::size_t an, int m){
+		if(m > 0){
+			limb hi = addmul_1(acc, a, an, (limb)m);
+			if(an < n)add_1(acc + an, acc + an, n - an, hi);
+		}
+		else if(m < 0){
+			limb hi = submul_1(acc, a, an, (limb)-m);
+			if(an < n)sub_1(acc + an, acc + an, n - an, hi);
+		}
+	}
+	//Splits a into K pieces of k limbs (the top one shorter) and writes |A(point)| to v, returns true for a negative value
+	template<std::size_t K>
+	inline bool toom_evaluate(limb* v, const int (&weights)[K], const limb* a, std::size_t an, std::size_t k){
+		mpn::zero(v, k + 1);
+		for(std::size_t i = 0;i < K;i++){
+			std::size_t len = i + 1 < K ? k : an - (K - 1) * k;
+			addmul_signed(v, k + 1, a + i * k, len, weights[i]);
+		}
+		bool negative = v[k] >> 63;
+		if(negative)neg(v, v, k + 1);
+		return negative;
+	}
+	//Recovers the product coefficients from the point values and adds them up into r, which has rn limbs
+	template<std::size_t K>
+	inline void toom_interpolate(limb* r, std::size_t rn, const limb* values, std::size_t k, std::size_t w, limb* acc,
+	                             const ToomScheme<K>& scheme){
+		constexpr std::size_t P = ToomScheme<K>::points;
+		mpn::zero(r, rn);
+		unsigned int shift = _trailing_zeros(scheme.divisor);
+		limb odd = scheme.divisor >> shift;
+		for(std::size_t i = 0;i < P;i++){
+			std::size_t offset = i * k;
+			if(offset >= rn)break;
+			mpn::zero(acc, w);
+			for(std::size_t j = 0;j < P;j++)
+				addmul_signed(acc, w, values + j * w, w, scheme.interpolation[i][j]);
+			if(shift)rshift(acc, acc, w, shift);
+			if(odd != 1)divexact_1(acc, acc, w, odd);
+			std::size_t len = std::min(w, rn - offset);
+			assert(isZero(acc + len, w - len));
+			add(r + offset, r + offset, rn - offset, acc, len);
+		}
+	}
+	//r = a * b with a and b split into K pieces of ceil(an / K) limbs each
+	template<std::size_t K>
+	inline void mul_toom(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn, const ToomScheme<K>& scheme){
+		constexpr std::size_t P = ToomScheme<K>::points;
+		std::size_t k = (an + K - 1) / K;
+		assert(bn > (K - 1) * k);
+		std::size_t w = 2 * k + 3;
+		//Points are multiplied concurrently in parallel mode and then need evaluation space of their own
+		ThreadPool* pool = parallelPoolFor(bn);
+		std::size_t evals = pool ? P : 1;
+		TempLimbs tmp(P * w + evals * 2 * (k + 1) + w);
+		limb* values = tmp;
+		limb* acc = values + P * w;
+		limb* evalSpace = acc + w;
+		auto point = [&](std::size_t j, limb* ea){
+			limb* eb = ea + k + 1;
+			limb* v = values + j * w;
+			mpn::zero(v, w);
+			bool na = toom_evaluate(ea, scheme.evaluation[j], a, an, k);
+			bool nb = toom_evaluate(eb, scheme.evaluation[j], b, bn, k);
+			std::size_t ean = normalizedSize(ea, k + 1);
+			std::size_t ebn = normalizedSize(eb, k + 1);
+			if(ean == 0 || ebn == 0)return;
+			if(ean >= ebn)mul(v, ea, ean, eb, ebn);
+			else mul(v, eb, ebn, ea, ean);
+			if(na != nb)neg(v, v, w);
+		};
+		TaskGroup tasks(pool);
+		for(std::size_t j = 0;j < P;j++){
+			limb* ea = evalSpace + (pool ? j : 0) * 2 * (k + 1);
+			tasks.run([&point, j, ea]{point(j, ea);});
+		}
+		tasks.wait();
+		toom_interpolate(r, an + bn, values, k, w, acc, scheme);
+	}
+	//r = a^2 with a split into K pieces, every point value is a square and therefore positive
+	template<std::size_t K>
+	inline void sqr_toom(limb* r, const limb* a, std::size_t n, const ToomScheme<K>& scheme){
+		constexpr std::size_t P = ToomScheme<K>::points;
+		std::size_t k = (n + K - 1) / K;
+		assert(n > (K - 1) * k);
+		std::size_t w = 2 * k + 3;
+		ThreadPool* pool = parallelPoolFor(n);
+		std::size_t evals = pool ? P : 1;
+		TempLimbs tmp(P * w + evals * (k + 1) + w);
+		limb* values = tmp;
+		limb* acc = values + P * w;
+		limb* evalSpace = acc + w;
+		auto point = [&](std::size_t j, limb* ea){
+			limb* v = values + j * w;
+			mpn::zero(v, w);
+			toom_evaluate(ea, scheme.evaluation[j], a, n, k);
+			std::size_t ean = normalizedSize(ea, k + 1);
+			if(ean)sqr(v, ea, ean);
+		};
+		TaskGroup tasks(pool);
+		for(std::size_t j = 0;j < P;j++){
+			limb* ea = evalSpace + (pool ? j : 0) * (k + 1);
+			tasks.run([&point, j, ea]{point(j, ea);});
+		}
+		tasks.wait();
+		toom_interpolate(r, 2 * n, values, k, w, acc, scheme);
+	}
+	/*
+	 * Arithmetic modulo an NTT prime p = c * 2^40 + 1 < 2^62 in Montgomery form (R = 2^64).
+	 * Values are kept fully reduced, so p < 2^62 leaves headroom for the lazy sums in mul.
+	 */
+	struct NttField{
+		limb p;
+		limb pinv;
+		limb r2;
+		limb root;
+		inline NttField(limb prime, limb generator) : p(prime), pinv(0 - binvert(prime)){
+			limb r1 = (0 - p) % p;
+			r2 = (limb)(((::uint_128bit)r1 * r1) % p);
+			root = toMont(generator);
+		}
+		inline limb mul(limb a, limb b)const{
+			unsigned long long hi, mh;
+			limb lo = mulx_u64(a, b, &hi);
+			limb m = lo * pinv;
+			mulx_u64(m, p, &mh);
+			limb t = hi + mh + (lo != 0);
+			return t >= p ? t - p : t;
+		}
+		inline limb add(limb a, limb b)const{
+			limb s = a + b;
+			return s >= p ? s - p : s;
+		}
+		inline limb sub(limb a, limb b)const{
+			return a >= b ? a - b : a + p - b;
+		}
+		inline limb toMont(limb a)const{return mul(a % p, r2);}
+		inline limb fromMont(limb a)const{return mul(a, 1);}
+		inline limb pow(limb base, limb e)const{
+			limb ret = toMont(1);
+			while(e){
+				if(e & 1)ret = mul(ret, base);
+				base = mul(base, base);
+				e >>= 1;
+			}
+			return ret;
+		}
+		//Montgomery form of the inverse of a (given in Montgomery form)
+		inline limb inverse(limb a)const{return pow(a, p - 2);}
+	};
+	constexpr std::size_t nttMaxLog = 40;
+	inline const std::array<NttField, 3>& nttFields(){
+		static const std::array<NttField, 3> fields = {
+			NttField(0x3fffc00000000001ULL, 11),
+			NttField(0x3fffbe0000000001ULL, 3),
+			NttField(0x3fff840000000001ULL, 19)
+		};
+		return fields;
+	}
+	//roots[len + j] = w^j for every power of two len < n, w a primitive 2len-th root of unity (or its inverse)
+	inline void ntt_roots(limb* roots, std::size_t n, const NttField& f, bool inverse, ThreadPool* pool = nullptr){
+		for(std::size_t len = 1;len < n;len <<= 1){
+			limb w = f.pow(f.root, (f.p - 1) / (2 * len));
+			if(inverse)w = f.inverse(w);
+			parallelFor(len >= parallelThreshold ? pool : nullptr, len, [&](std::size_t b, std::size_t e){
+				roots[len + b] = f.pow(w, b);
+				for(std::size_t j = b + 1;j < e;j++)roots[len + j] = f.mul(roots[len + j - 1], w);
+			});
+		}
+	}
+	/*
+	 * Block size from which the transforms of a parallel NTT are independent: the levels with fewer blocks
+	 * than there are tasks split their butterflies between the threads, each smaller block is then
+	 * transformed by one thread on its own.
+	 */
+	inline std::size_t ntt_blockSize(std::size_t n, const ThreadPool& pool){
+		std::size_t m = n;
+		while(m > 1 && n / m < 4 * (pool.size() + 1))m >>= 1;
+		return m;
+	}
+	//Decimation in frequency, the output is in bit reversed order
+	inline void ntt_forward(limb* a, std::size_t n, const NttField& f, const limb* roots, ThreadPool* pool = nullptr){
+		std::size_t len = n / 2;
+		if(pool){
+			std::size_t m = ntt_blockSize(n, *pool);
+			for(;len >= m && len >= 1;len >>= 1){
+				parallelFor(pool, n / 2, [&](std::size_t b, std::size_t e){
+					for(std::size_t t = b;t < e;t++){
+						std::size_t j = t & (len - 1);
+						limb* x = a + 2 * (t - j) + j;
+						limb u = x[0];
+						limb v = x[len];
+						x[0] = f.add(u, v);
+						x[len] = f.mul(f.sub(u, v), roots[len + j]);
+					}
+				});
+			}
+			parallelFor(pool, n / m, [&](std::size_t b, std::size_t e){
+				for(std::size_t i = b;i < e;i++)ntt_forward(a + i * m, m, f, roots);
+			});
+			return;
+		}
+		for(;len >= 1;len >>= 1){
+			for(std::size_t i = 0;i < n;i += 2 * len){
+				for(std::size_t j = 0;j < len;j++){
+					limb u = a[i + j];
+					limb v = a[i + j + len];
+					a[i + j] = f.add(u, v);
+					a[i + j + len] = f.mul(f.sub(u, v), roots[len + j]);
+				}
+			}
+		}
+	}
+	//Decimation in time from bit reversed input, the output is in natural order and scaled by n
+	inline void ntt_inverse(limb* a, std::size_t n, const NttField& f, const limb* roots, ThreadPool* pool = nullptr){
+		if(pool){
+			std::size_t m = ntt_blockSize(n, *pool);
+			parallelFor(pool, n / m, [&](std::size_t b, std::size_t e){
+				for(std::size_t i = b;i < e;i++)ntt_inverse(a + i * m, m, f, roots);
+			});
+			for(std::size_t len = m;len < n;len <<= 1){
+				parallelFor(pool, n / 2, [&](std::size_t b, std::size_t e){
+					for(std::size_t t = b;t < e;t++){
+						std::size_t j = t & (len - 1);
+						limb* x = a + 2 * (t - j) + j;
+						limb u = x[0];
+						limb v = f.mul(x[len], roots[len + j]);
+						x[0] = f.add(u, v);
+						x[len] = f.sub(u, v);
+					}
+				});
+			}
+			return;
+		}
+		for(std::size_t len = 1;len < n;len <<= 1){
+			for(std::size_t i = 0;i < n;i += 2 * len){
+				for(std::size_t j = 0;j < len;j++){
+					limb u = a[i + j];
+					limb v = f.mul(a[i + j + len], roots[len + j]);
+					a[i + j] = f.add(u, v);
+					a[i + j + len] = f.sub(u, v);
+				}
+			}
+		}
+	}
+	//res = the cyclic convolution of a and b modulo f.p, with n >= an + bn - 1 so that nothing wraps; a == b transforms once
+	inline void ntt_convolve(limb* res, std::size_t rn, const limb* a, std::size_t an, const limb* b, std::size_t bn,
+	                         std::size_t n, const NttField& f, limb* work, ThreadPool* pool = nullptr){
+		limb* fa = work;
+		limb* fb = fa + n;
+		limb* roots = fb + n;
+		bool square = a == b && an == bn;
+		for(std::size_t i = 0;i < an;i++)fa[i] = a[i] % f.p;
+		mpn::zero(fa + an, n - an);
+		ntt_roots(roots, n, f, false, pool);
+		ntt_forward(fa, n, f, roots, pool);
+		if(square)fb = fa;
+		else{
+			for(std::size_t i = 0;i < bn;i++)fb[i] = b[i] % f.p;
+			mpn::zero(fb + bn, n - bn);
+			ntt_forward(fb, n, f, roots, pool);
+		}
+		//Pointwise products carry a factor 1/R, the scale below removes it together with n
+		parallelFor(pool, n, [&](std::size_t b, std::size_t e){
+			for(std::size_t i = b;i < e;i++)fa[i] = f.mul(fa[i], fb[i]);
+		});
+		ntt_roots(roots, n, f, true, pool);
+		ntt_inverse(fa, n, f, roots, pool);
+		limb scale = f.mul(f.toMont(f.p - (f.p - 1) / n), f.r2);
+		parallelFor(pool, rn, [&](std::size_t b, std::size_t e){
+			for(std::size_t i = b;i < e;i++)res[i] = f.mul(fa[i], scale);
+		});
+	}
+	/*
+	 * Combines the three residues of every coefficient (Garner) and propagates the carries into r.
+	 * In parallel every chunk of coefficients is summed up on its own and leaves a two limb carry,
+	 * the carries are added in afterwards from the lowest chunk up.
+	 */
+	inline void ntt_recombine(limb* r, std::size_t rn, const limb* res0, const limb* res1, const limb* res2, std::size_t cn,
+	                          ThreadPool* pool = nullptr){
+		const std::array<NttField, 3>& f = nttFields();
+		limb p0 = f[0].p, p1 = f[1].p, p2 = f[2].p;
+		//Montgomery forms of 1/p0 mod p1, 1/(p0 p1) mod p2 and p0 mod p2
+		limb inv01 = f[1].inverse(f[1].toMont(p0));
+		limb p0m2 = f[2].toMont(p0);
+		limb inv012 = f[2].inverse(f[2].mul(p0m2, f[2].toMont(p1)));
+		unsigned long long p01hi;
+		limb p01[2];
+		p01[0] = mulx_u64(p0, p1, &p01hi);
+		p01[1] = p01hi;
+		std::size_t chunks = pool ? std::min(cn, 4 * (pool->size() + 1)) : 1;
+		TempLimbs carries(2 * chunks);
+		parallelFor(pool, chunks, [&](std::size_t cb, std::size_t ce){
+			for(std::size_t c = cb;c < ce;c++){
+				limb acc[3] = {0, 0, 0};
+				for(std::size_t i = cn * c / chunks;i < cn * (c + 1) / chunks;i++){
+					limb x0 = res0[i];
+					limb x0m1 = x0 >= p1 ? x0 - p1 : x0;
+					limb x1 = f[1].mul(f[1].sub(res1[i], x0m1), inv01);
+					limb x0m2 = x0 >= p2 ? x0 - p2 : x0;
+					limb x1m2 = x1 >= p2 ? x1 - p2 : x1;
+					limb y = f[2].add(x0m2, f[2].mul(x1m2, p0m2));
+					limb x2 = f[2].mul(f[2].sub(res2[i], y), inv012);
+					//acc += x0 + x1 * p0 + x2 * p0 * p1
+					unsigned long long thi;
+					limb t[3];
+					t[0] = mulx_u64(x1, p0, &thi);
+					t[1] = thi;
+					t[2] = 0;
+					add_1(t, t, 3, x0);
+					limb u[3];
+					u[2] = mul_1(u, p01, 2, x2);
+					add_n(t, t, u, 3);
+					add_n(acc, acc, t, 3);
+					r[i] = acc[0];
+					acc[0] = acc[1];
+					acc[1] = acc[2];
+					acc[2] = 0;
+				}
+				carries[2 * c] = acc[0];
+				carries[2 * c + 1] = acc[1];
+			}
+		});
+		mpn::zero(r + cn, rn - cn);
+		for(std::size_t c = 0;c < chunks;c++){
+			std::size_t e = cn * (c + 1) / chunks;
+			std::size_t len = std::min<std::size_t>(2, rn - e);
+			assert(len == 2 || carries[2 * c + 1] == 0);
+			add(r + e, r + e, rn - e, carries + 2 * c, len);
+		}
+	}
+	//r = a * b with a three prime number theoretic transform, r has an + bn limbs and must not overlap a or b; a == b squares
+	inline void mul_ntt(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		std::size_t rn = an + bn;
+		std::size_t cn = rn - 1;
+		std::size_t n = 1;
+		while(n < cn)n <<= 1;
+		assert(n <= ((std::size_t)1 << nttMaxLog));
+		//The three primes run concurrently in parallel mode, each with work space of its own
+		ThreadPool* pool = parallelPoolFor(bn);
+		TempLimbs tmp(3 * cn + (pool ? 3 : 1) * 3 * n);
+		limb* res = tmp;
+		limb* work = res + 3 * cn;
+		const std::array<NttField, 3>& f = nttFields();
+		TaskGroup tasks(pool);
+		for(int k = 0;k < 3;k++){
+			limb* w = work + (pool ? k : 0) * 3 * n;
+			tasks.run([&, k, w]{ntt_convolve(res + k * cn, cn, a, an, b, bn, n, f[k], w, pool);});
+		}
+		tasks.wait();
+		ntt_recombine(r, rn, res, res + cn, res + 2 * cn, cn, pool);
+	}
+	//r = a * b for an much larger than bn, one bn-sized slice of a at a time
+	inline void mul_unbalanced(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		TempLimbs tmp(2 * bn);
+		mpn::zero(r, an + bn);
+		for(std::size_t i = 0;i < an;i += bn){
+			std::size_t cn = std::min(bn, an - i);
+			mul(tmp, b, bn, a + i, cn);
+			add(r + i, r + i, an + bn - i, tmp, cn + bn);
+		}
+	}
+	//r = a * b for an >= bn >= 1, r has an + bn limbs and must not overlap a or b
+	inline void mul_blocked(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn, std::size_t block);
+	inline void mul(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn){
+		assert(an >= bn && bn >= 1);
+		if(outOfCoreLimbs && an + bn > outOfCoreLimbs)return mul_blocked(r, a, an, b, bn, std::max<std::size_t>(1, outOfCoreLimbs / 2));
+		if(a == b && an == bn)return sqr(r, a, an);
+		const MultThresholds& t = multThresholds;
+		if(bn < t.karatsuba)mul_basecase(r, a, an, b, bn);
+		else if(bn >= t.ntt && 4 * bn >= an)mul_ntt(r, a, an, b, bn);
+		else if(bn >= t.toom4 && bn > 3 * ((an + 3) / 4))mul_toom(r, a, an, b, bn, toom4Scheme);
+		else if(bn >= t.toom3 && bn > 2 * ((an + 2) / 3))mul_toom(r, a, an, b, bn, toom3Scheme);
+		else if(bn > (an + 1) / 2)mul_karatsuba(r, a, an, b, bn);
+		else mul_unbalanced(r, a, an, b, bn);
+	}
+	//r = a^2 for n >= 1, r has 2n limbs and must not overlap a
+	inline void sqr(limb* r, const limb* a, std::size_t n){
+		if(outOfCoreLimbs && 2 * n > outOfCoreLimbs)return mul_blocked(r, a, n, a, n, std::max<std::size_t>(1, outOfCoreLimbs / 2));
+		const MultThresholds& t = sqrThresholds;
+		if(n < t.karatsuba)sqr_basecase(r, a, n);
+		else if(n >= t.ntt)mul_ntt(r, a, n, a, n);
+		else if(n >= t.toom4 && n > 3 * ((n + 3) / 4))sqr_toom(r, a, n, toom4Scheme);
+		else if(n >= t.toom3 && n > 2 * ((n + 2) / 3))sqr_toom(r, a, n, toom3Scheme);
+		else sqr_karatsuba(r, a, n);
+	}
+	//r = a * b block by block, the result is swept once per block of a
+	inline void mul_blocked(limb* r, const limb* a, std::size_t an, const limb* b, std::size_t bn, std::size_t block){
+		zero(r, an + bn);
+		TempLimbs t(2 * block);
+		for(std::size_t i = 0;i < an;i += block){
+			std::size_t ai = std::min(block, an - i);
+			for(std::size_t j = 0;j < bn;j += block){
+				std::size_t bj = std::min(block, bn - j);
+				if(ai >= bj)mul(t, a + i, ai, b + j, bj);
+				else mul(t, b + j, bj, a + i, ai);
+				add(r + i + j, r + i + j, an + bn - i - j, t, ai + bj);
+			}
+		}
+	}
+	//Divisor size (in limbs) from which divrem recurses instead of running algorithm D directly, values below 4 act as 4
+	inline std::size_t divThreshold = 32;
+	//Every recursive step has to leave halves of at least 2 limbs for algorithm D
+	inline std::size_t divCutoff(){
+		return std::max<std::size_t>(divThreshold, 4);
+	}
+	/*
+	 * Recursive division of Burnikel and Ziegler on a normalized divisor: q = u / v for 2n-limb u and n-limb v.
+	 * Each half of the quotient comes from dividing by the top half of v and is then corrected with one
+	 * multiplication by the bottom half, so the cost is a constant times that of an n-limb mul.
+	 * q has n limbs, u is replaced by the remainder in its low n limbs, t has n limbs of scratch.
+	 * Returns the quotient limb above q as divrem_basecase_norm does.
+	 */
+	inline limb divrem_dc_n(limb* q, limb* u, const limb* v, std::size_t n, limb* t){
+		if(n < divCutoff())return divrem_basecase_norm(q, u, 2 * n, v, n);
+		std::size_t lo = n / 2, hi = n - lo;
+		//Top hi quotient limbs from the top 2hi limbs of u and the top hi limbs of v
+		limb qh = divrem_dc_n(q + lo, u + 2 * lo, v + lo, hi, t);
+		mul(t, q + lo, hi, v, lo);
+		limb c = sub_n(u + lo, u + lo, t, n);
+		if(qh)c += sub_n(u + n, u + n, v, lo);
+		while(c){
+			qh -= sub_1(q + lo, q + lo, hi, 1);
+			c -= add_n(u + lo, u + lo, v, n);
+		}
+		//Bottom lo quotient limbs likewise from the partial remainder
+		limb ql = divrem_dc_n(q, u + hi, v + hi, lo, t);
+		mul(t, v, hi, q, lo);
+		c = sub_n(u, u, t, n);
+		if(ql)c += sub_n(u + lo, u + lo, v, hi);
+		while(c){
+			sub_1(q, q, lo, 1);
+			c -= add_n(u, u, v, n);
+		}
+		return qh;
+	}
+	/*
+	 * q = u / v for un > dn on a normalized divisor where the top dn limbs of u are below v, one dn-limb block
+	 * of the quotient at a time from the top. A shorter top block of b limbs is estimated from the top b limbs
+	 * of v and corrected with a b by dn - b multiplication.
+	 */
+	inline void divrem_dc(limb* q, limb* u, std::size_t un, const limb* v, std::size_t dn){
+		std::size_t qn = un - dn;
+		TempLimbs tmp(dn);
+		limb* t = tmp;
+		std::size_t b = qn % dn;
+		if(b){
+			std::size_t pos = qn - b;
+			limb qh;
+			if(b < divCutoff())qh = divrem_basecase_norm(q + pos, u + pos, dn + b, v, dn);
+			else{
+				qh = divrem_dc_n(q + pos, u + un - 2 * b, v + dn - b, b, t);
+				std::size_t ln = dn - b;
+				TempLimbs prod(dn);
+				if(ln >= b)mul(prod, v, ln, q + pos, b);
+				else mul(prod, q + pos, b, v, ln);
+				limb c = sub_n(u + pos, u + pos, prod, dn);
+				if(qh)c += sub_n(u + pos + b, u + pos + b, v, ln);
+				while(c){
+					qh -= sub_1(q + pos, q + pos, b, 1);
+					c -= add_n(u + pos, u + pos, v, dn);
+				}
+			}
+			assert(!qh);
+			(void)qh;
+			qn = pos;
+		}
+		while(qn > 0){
+			qn -= dn;
+			limb qh = divrem_dc_n(q + qn, u + qn, v, dn, t);
+			assert(!qh);
+			(void)qh;
+		}
+	}
+	//q = a / d and r = a % d for an >= dn >= 1 and d[dn - 1] != 0; q has an - dn + 1 limbs, r has dn limbs
+	inline void divrem(limb* q, limb* r, const limb* a, std::size_t an, const limb* d, std::size_t dn){
+		if(dn == 1){
+			r[0] = divrem_1(q, a, an, d[0]);
+			return;
+		}
+		if(dn < divCutoff() || an - dn < divCutoff())return divrem_basecase(q, r, a, an, d, dn);
+		unsigned int shift = _leading_zeros(d[dn - 1]);
+		TempLimbs tmp(an + 1 + dn);
+		limb* u = tmp;
+		limb* v = u + an + 1;
+		if(shift){
+			lshift(v, d, dn, shift);
+			u[an] = lshift(u, a, an, shift);
+		}
+		else{
+			mpn::copy(v, d, dn);
+			mpn::copy(u, a, an);
+			u[an] = 0;
+		}
+		divrem_dc(q, u, an + 1, v, dn);
+		if(shift)rshift(r, u, dn, shift);
+		else mpn::copy(r, u, dn);
+	}
+	/*
+	 * Montgomery reduction modulo an odd m of n limbs with R = 2^(64n) and minv = -1/m mod 2^64.
+	 * Operands are n-limb residues below m.
+	 */
+	//r = t / R mod m for t < m R, t has 2n + 1 limbs (the top one zero) and is destroyed
+	inline void redc(limb* r, limb* t, const limb* m, std::size_t n, limb minv){
+		for(std::size_t i = 0;i < n;i++){
+			limb q = t[i] * minv;
+			limb c = addmul_1(t + i, m, n, q);
+			add_1(t + i + n, t + i + n, n + 1 - i, c);
+		}
+		if(t[2 * n] || cmp_n(t + n, m, n) >= 0)sub_n(r, t + n, m, n);
+		else mpn::copy(r, t + n, n);
+	}
+	//r = a b / R mod m with multiplication and reduction interleaved limb by limb, t has 2n + 2 limbs
+	inline void mont_mul_basecase(limb* r, const limb* a, const limb* b, const limb* m, std::size_t n, limb minv, limb* t){
+		mpn::zero(t, 2 * n + 2);
+		for(std::size_t i = 0;i < n;i++){
+			limb c = addmul_1(t + i, a, n, b[i]);
+			add_1(t + i + n, t + i + n, 2, c);
+			limb q = t[i] * minv;
+			c = addmul_1(t + i, m, n, q);
+			add_1(t + i + n, t + i + n, 2, c);
+		}
+		if(t[2 * n] || cmp_n(t + n, m, n) >= 0)sub_n(r, t + n, m, n);
+		else mpn::copy(r, t + n, n);
+	}
+	//Scratch limbs needed by mont_mul and mont_sqr
+	inline std::size_t mont_scratch(std::size_t n){return 2 * n + 2;}
+	//r = a b / R mod m, r may alias a or b
+	inline void mont_mul(limb* r, const limb* a, const limb* b, const limb* m, std::size_t n, limb minv, limb* t){
+		if(n < multThresholds.karatsuba)return mont_mul_basecase(r, a, b, m, n, minv, t);
+		mul(t, a, n, b, n);
+		t[2 * n] = 0;
+		redc(r, t, m, n, minv);
+	}
+	//r = a^2 / R mod m, r may alias a; the halved cross products make this cheaper than the fused kernel at every size
+	inline void mont_sqr(limb* r, const limb* a, const limb* m, std::size_t n, limb minv, limb* t){
+		sqr(t, a, n);
+		t[2 * n] = 0;
+		redc(r, t, m, n, minv);
+	}
+	/*
+	 * Barrett reduction modulo m of n limbs with mu = floor(2^(128n) / m) of mun limbs (Handbook of Applied
+	 * Cryptography 14.42). The quotient estimate taken from the top n + 1 limbs of x times mu is at most two short,
+	 * so two multiplications and at most two subtractions replace the long division.
+	 */
+	//Scratch limbs needed by barrett_reduce
+	inline std::size_t barrett_scratch(std::size_t n){return 7 * n + 5;}
+	//r = x mod m for x of at most 2n limbs, r has n limbs and may alias x
+	inline void barrett_reduce_2n(limb* r, const limb* x, std::size_t xn, const limb* m, std::size_t n, const limb* mu, std::size_t mun, limb* t){
+		assert(xn <= 2 * n && mun >= n + 1);
+		xn = normalizedSize(x, xn);
+		if(cmp(x, xn, m, n) < 0){
+			copy(r, x, xn);
+			zero(r + xn, n - xn);
+			return;
+		}
+		limb* q = t;
+		limb* p = q + 2 * n + 3;
+		limb* w = p + 2 * n + 1;
+		//q3 = floor(floor(x / b^(n - 1)) mu / b^(n + 1)) of at most n + 1 limbs
+		const limb* q1 = x + n - 1;
+		std::size_t q1n = xn - n + 1;
+		if(q1n >= mun)mul(q, q1, q1n, mu, mun);
+		else mul(q, mu, mun, q1, q1n);
+		const limb* q3 = q + n + 1;
+		std::size_t q3n = normalizedSize(q3, q1n + mun - n - 1);
+		//w = (x - q3 m) mod b^(n + 1), which is below 3m
+		copy(w, x, std::min(xn, n + 1));
+		if(xn == n)w[n] = 0;
+		if(q3n){
+			if(q3n >= n)mul(p, q3, q3n, m, n);
+			else mul(p, m, n, q3, q3n);
+			sub_n(w, w, p, n + 1);
+		}
+		while(w[n] || cmp_n(w, m, n) >= 0)w[n] -= sub_n(w, w, m, n);
+		copy(r, w, n);
+	}
+	//r = x mod m for x of any length, folding n limbs at a time into the remainder from the top
+	inline void barrett_reduce(limb* r, const limb* x, std::size_t xn, const limb* m, std::size_t n, const limb* mu, std::size_t mun, limb* t){
+		if(xn <= 2 * n)return barrett_reduce_2n(r, x, xn, m, n, mu, mun, t);
+		limb* w = t + 5 * n + 5;
+		std::size_t pos = xn - 2 * n;
+		barrett_reduce_2n(w, x + pos, 2 * n, m, n, mu, mun, t);
+		while(pos > 0){
+			std::size_t c = std::min(n, pos);
+			pos -= c;
+			copy(w + c, w, n);
+			copy(w, x + pos, c);
+			barrett_reduce_2n(w, w, c + n, m, n, mu, mun, t);
+		}
+		copy(r, w, n);
+	}
+}
+struct MontgomeryContext;
+template<std::size_t Bits>
+struct ModulusConstants;
+/*
+ * Non owning, read only view of a signed number whose limbs (least significant first) live elsewhere: a network
+ * buffer, an mmap'd file, a slice of a larger array or a constexpr FixedInt in read only data.
+ * Every read only BigInt operation takes views, and a BigInt converts to one implicitly.
+ */
+struct BigIntView{
+	using uint64_t = std::uint64_t;
+	using size_t = std::size_t;
+	const uint64_t* ptr;
+	size_t n;
+	int signum;
+	constexpr BigIntView(const uint64_t* limbs, size_t count, int sign = 1) : ptr(limbs), n(count), signum(sign){}
+	constexpr size_t size()const{return n;}
+	constexpr const uint64_t* limbs()const{return ptr;}
+	constexpr const uint64_t* begin()const{return ptr;}
+	constexpr const uint64_t* end()const{return ptr + n;}
+	constexpr const uint64_t& operator[](size_t i)const{return ptr[i];}
+	inline size_t normalizedSize()const{return mpn::normalizedSize(ptr, n);}
+	inline bool isZero()const{return mpn::isZero(ptr, n);}
+	inline size_t bitLength()const{return mpn::bitLength(ptr, n);}
+	//Past one limb the reciprocal of m pays for itself
+	inline uint64_t mod(uint64_t m)const{return n > 1 ? mpn::mod_1(ptr, n, mpn::LimbDivisor(m)) : mpn::mod_1(ptr, n, m);}
+	inline uint64_t mod(const mpn::LimbDivisor& d)const{return n ? mpn::mod_1(ptr, n, d) : 0;}
+	inline int compareMagnitude(const BigIntView& o)const{return mpn::cmp(ptr, n, o.ptr, o.n);}
+	//Zero compares equal whatever its signum
+	inline int compare(const BigIntView& o)const{
+		if(signum != o.signum && !(isZero() && o.isZero()))return signum < o.signum ? -1 : 1;
+		return signum < 0 ? -compareMagnitude(o) : compareMagnitude(o);
+	}
+	inline bool operator==(const BigIntView& o)const{return compare(o) == 0;}
+	inline bool operator!=(const BigIntView& o)const{return compare(o) != 0;}
+	//Decimal digits of the magnitude like BigInt::toString
+	inline std::string toString()const;
+};
+//A view whose limbs are written in place by the three operand BigInt operations, which also set its signum
+struct MutableBigIntView{
+	using uint64_t = std::uint64_t;
+	using size_t = std::size_t;
+	uint64_t* ptr;
+	size_t n;
+	int signum;
+	constexpr MutableBigIntView(uint64_t* limbs, size_t count, int sign = 1) : ptr(limbs), n(count), signum(sign){}
+	constexpr operator BigIntView()const{return BigIntView(ptr, n, signum);}
+	constexpr size_t size()const{return n;}
+	constexpr uint64_t* limbs()const{return ptr;}
+	constexpr uint64_t* begin()const{return ptr;}
+	constexpr uint64_t* end()const{return ptr + n;}
+	constexpr uint64_t& operator[](size_t i)const{return ptr[i];}
+	inline bool isZero()const{return mpn::isZero(ptr, n);}
+	inline void setZero(){
+		mpn::zero(ptr, n);
+		signum = 1;
+	}
+};
+//Payload encodings of the binary format, see BigInt::toBinary
+enum class BigIntFormat : unsigned char{limbs, varint};
+//Base of the lazily evaluated BigInt expressions (BigIntProduct, BigIntSum)
+template<typename E>
+struct BigIntExpr{
+	inline const E& self()const{return static_cast<const E&>(*this);}
+};
+struct BigInt{
+	using lui = ::uint_128bit;
+	using size_t = std::size_t;
+	using ssize_t = std::int64_t;
+	using uint64_t = std::uint64_t;
+	using uint32_t = std::uint32_t;
+	using iterator = LimbVector::iterator;
+	using const_iterator = LimbVector::const_iterator;
+	using reverse_iterator = LimbVector::reverse_iterator;
+	using const_reverse_iterator = LimbVector::const_reverse_iterator;
+	//Limbs, least significant first
+	LimbVector data;
+	int signum;
+	inline BigInt() : data(1,0),signum(1){}
+	inline BigInt(size_t _s, uint64_t fill) : data(_s, fill), signum(1){}
+	//Zero with its limbs taken from a, e.g. a MonotonicLimbAllocator; the result of three operand arithmetic into it stays there
+	inline explicit BigInt(LimbAllocator* a) : data(a), signum(1){data.resize(1, 0);}
+	inline BigInt(int a) :  data(1, std::abs((long long)a)),signum(::signum(a)){}
+	inline BigInt(unsigned int a) : data(1, a),signum(1){}
+	inline BigInt(unsigned long long a) : data(1, a), signum(1){}
+	inline BigInt(long long a) : data(1, a < 0 ? 0 - (uint64_t)a : (uint64_t)a),signum(::signum(a)){}
+	//Brace lists used to give the limbs most significant first, so they no longer compile; use fromLimbs
+	BigInt(std::initializer_list<uint64_t>) = delete;
+	inline BigInt(const BigInt& o) : data(o.data), signum(o.signum){}
+	inline BigInt(BigInt&& o) : data(std::move(o.data)), signum(o.signum){}
+	//Copies the viewed limbs
+	inline explicit BigInt(const BigIntView& v) : data(v.begin(), v.end()), signum(v.signum){}
+	inline BigIntView view()const{return BigIntView(limbs(), size(), signum);}
+	inline operator BigIntView()const{return view();}
+	//The limbs stay owned by this and the view is invalidated when they are reallocated
+	inline MutableBigIntView mutableView(){return MutableBigIntView(limbs(), size(), signum);}
+	//Limbs are given least significant first
+	template<typename InputIterator>
+	static inline BigInt fromLimbs(InputIterator first, InputIterator last){
+		BigInt ret;
+		if(first != last)ret.data.assign(first, last);
+		return ret;
+	}
+	static inline BigInt fromLimbs(std::initializer_list<uint64_t> l){return fromLimbs(l.begin(), l.end());}
+	//Random limbs from a generator, which has to be callable so strings with a base pick the parsing constructor
+	template<typename RNG, typename = std::enable_if_t<std::is_invocable_r<uint64_t, RNG&>::value>>
+	inline BigInt(RNG& rng, size_t length) : data(length, 0), signum(1){std::generate(data.begin(),data.end(), [&rng](){return rng();});}
+	inline iterator begin(){return data.begin();}
+	inline iterator end(){return data.end();}
+	inline reverse_iterator rbegin(){return data.rbegin();}
+	inline reverse_iterator rend(){return data.rend();}
+	inline const_iterator begin()const{return data.begin();}
+	inline const_iterator end()const{return data.end();}
+	inline const_reverse_iterator rbegin()const{return data.rbegin();}
+	inline const_reverse_iterator rend()const{return data.rend();}
+	inline const_iterator cbegin()const{return data.begin();}
+	inline const_iterator cend()const{return data.end();}
+	inline const_reverse_iterator crbegin()const{return data.rbegin();}
+	inline const_reverse_iterator crend()const{return data.rend();}
+	//Limb i, least significant first
+	inline uint64_t& limbAt(size_t i){return data[i];}
+	inline const uint64_t& limbAt(size_t i)const{return data.at(i);}
+	inline size_t size()const{return data.size();}
+	inline uint64_t* limbs(){return data.data();}
+	inline const uint64_t* limbs()const{return data.data();}
+	inline BigInt& operator=(const BigInt& o){signum = o.signum;data = o.data;return *this;}
+	inline BigInt& operator=(BigInt&& o){data = std::move(o.data);signum = o.signum;return *this;}
+	/*
+	 * Expressions like a * b + c are evaluated straight into the limbs of the result, which is sized for the
+	 * whole expression up front. Intermediate products only need scratch space when they are added to
+	 * something, and assigning to an existing BigInt reuses its capacity.
+	 */
+	template<typename E>
+	inline BigInt(const BigIntExpr<E>& e) : signum(1){
+		data.reserve(e.self().bound());
+		e.self().evalInto(*this);
+	}
+	template<typename E>
+	inline BigInt& operator=(const BigIntExpr<E>& e){
+		data.reserve(e.self().bound());
+		e.self().evalInto(*this);
+		return *this;
+	}
+	inline void swap(BigInt& o){
+		data.swap(o.data);
+		std::swap(signum, o.signum);
+	}
+	inline BigInt(const std::string& o) : BigInt(std::string_view(o)){}
+	inline BigInt(const char* o) : BigInt(std::string_view(o)){}
+	//Parses an optionally signed decimal number, throws std::invalid_argument on malformed input
+	inline explicit BigInt(std::string_view o) : BigInt(parse(o.data(), o.data() + o.size())){}
+	//Parses an optionally signed number in base 2 to 36 with digits in either case, the inverse of toString(base)
+	inline BigInt(std::string_view o, unsigned int base) : BigInt(parse(o.data(), o.data() + o.size(), base)){}
+	static inline std::invalid_argument invalidCharacter(const char* begin, const char* c, const char* last){
+		return std::invalid_argument("BigInt: invalid character '" + std::string(1, *c) + "' at position " +
+		                             std::to_string(c - begin) + " in \"" + std::string(begin, last) + "\"");
+	}
+	static inline BigInt parse(const char* first, const char* last, unsigned int base){
+		if(base == 10)return parse(first, last);
+		if(base < 2 || base > chars.size())throw std::invalid_argument("BigInt: base " + std::to_string(base) + " is not in [2, 36]");
+		const char* begin = first;
+		int sign = 1;
+		if(first != last && (*first == '-' || *first == '+')){
+			sign = *first == '-' ? -1 : 1;
+			++first;
+		}
+		if(first == last)throw std::invalid_argument("BigInt: no digits in \"" + std::string(begin, last) + "\"");
+		size_t count = (size_t)(last - first);
+		auto digit = [&](const char* c)->uint64_t{
+			unsigned int d = digitValues[(unsigned char)*c];
+			if(d >= base)throw invalidCharacter(begin, c, last);
+			return d;
+		};
+		BigInt ret;
+		if(!(base & (base - 1))){
+			//Every digit lands on its own bits, the last character holds the lowest ones
+			unsigned int bits = (unsigned int)_trailing_zeros(base);
+			ret.data.resize((count * bits + 63) / 64, 0);
+			uint64_t* r = ret.limbs();
+			size_t pos = 0;
+			for(const char* c = last;c-- != first;pos += bits){
+				uint64_t d = digit(c);
+				size_t limb = pos / 64;
+				unsigned int sh = pos % 64;
+				r[limb] |= d << sh;
+				if(sh + bits > 64)r[limb + 1] |= d >> (64 - sh);
+			}
+		}
+		else{
+			//Horner's rule on chunks of k digits, base^k being the largest power in a limb
+			uint64_t big = base;
+			unsigned int k = 1;
+			while(big <= ~(uint64_t)0 / base){
+				big *= base;
+				++k;
+			}
+			ret.data.resize(count / k + 1, 0);
+			uint64_t* r = ret.limbs();
+			size_t rn = 0;
+			size_t head = count % k ? count % k : k;
+			for(const char* c = first;c != last;){
+				const char* end = c + head;
+				uint64_t v = 0, scale = 1;
+				for(;c != end;++c){
+					v = v * base + digit(c);
+					scale *= base;
+				}
+				head = k;
+				uint64_t carry = mpn::mul_1(r, r, rn, scale);
+				if(carry)r[rn++] = carry;
+				carry = mpn::add_1(r, r, rn, v);
+				if(carry)r[rn++] = carry;
+			}
+		}
+		ret.trim();
+		ret.signum = ret.isZero() ? 1 : sign;
+		return ret;
+	}
+	static inline BigInt fromHex(std::string_view o){
+		return parse(o.data(), o.data() + o.size(), 16);
+	}
+	//Inverse of toBase64, accepting either alphabet with or without padding; throws std::invalid_argument otherwise
+	static inline BigInt fromBase64(std::string_view o){
+		const char* begin = o.data();
+		const char* last = begin + o.size();
+		size_t pad = 0;
+		while(pad < 2 && last != begin && last[-1] == '='){
+			--last;
+			++pad;
+		}
+		size_t count = (size_t)(last - begin);
+		if(count % 4 == 1 || (pad && (count + pad) % 4))
+			throw std::invalid_argument("BigInt: bad base64 length in \"" + std::string(o) + "\"");
+		size_t bytes = count * 6 / 8;
+		BigInt ret(std::max<size_t>(1, (bytes + 7) / 8), 0);
+		uint64_t* r = ret.limbs();
+		//Bits are collected from the most significant end, byte i from the left is byte bytes - 1 - i from the right
+		unsigned int acc = 0, held = 0;
+		size_t i = 0;
+		for(const char* c = begin;c != last;++c){
+			unsigned int d = base64Values[(unsigned char)*c];
+			if(d > 63)throw invalidCharacter(begin, c, begin + o.size());
+			acc = (acc << 6 | d) & 0xffff;
+			held += 6;
+			if(held >= 8){
+				held -= 8;
+				size_t j = bytes - 1 - i++;
+				r[j / 8] |= (uint64_t)((acc >> held) & 0xff) << (8 * (j % 8));
+			}
+		}
+		return ret.trim();
+	}
+	static inline BigInt parse(const char* first, const char* last){
+		const char* begin = first;
+		int sign = 1;
+		if(first != last && (*first == '-' || *first == '+')){
+			sign = *first == '-' ? -1 : 1;
+			++first;
+		}
+		if(first == last)throw std::invalid_argument("BigInt: no digits in \"" + std::string(begin, last) + "\"");
+		//Chunks of 19 digits from the right, chunk 0 is the least significant
+		size_t chunks = ((size_t)(last - first) + 18) / 19;
+		BigInt ret(chunks, 0);
+		uint64_t* r = ret.limbs();
+		for(size_t i = 0;i < chunks;i++){
+			const char* end = last - 19 * i;
+			const char* start = end - first > 19 ? end - 19 : first;
+			uint64_t v = 0;
+			for(const char* c = start;c != end;++c){
+				if(*c < '0' || *c > '9')throw invalidCharacter(begin, c, last);
+				v = v * 10 + (uint64_t)(*c - '0');
+			}
+			r[i] = v;
+		}
+		/*
+		 * Combine neighbouring blocks of 2^k chunks as hi * 10^(19 * 2^k) + lo. A block of c chunks is below
+		 * 2^(64c), so every block is evaluated in place within its own chunk range and the pairs of one
+		 * level are independent of each other.
+		 */
+		ThreadPool* pool = mpn::parallelPoolFor(chunks);
+		for(size_t k = 0, block = 1;block < chunks;k++, block <<= 1){
+			const BigInt& p = decimalPower(k, 19);
+			size_t pn = p.size();
+			size_t pairs = (chunks - block + 2 * block - 1) / (2 * block);
+			parallelFor(pool, pairs, [&](size_t pb, size_t pe){
+				mpn::TempLimbs tmp(std::min(2 * block, chunks));
+				for(size_t lo = 2 * block * pb;lo < 2 * block * pe;lo += 2 * block){
+					uint64_t* hi = r + lo + block;
+					size_t hs = std::min(block, chunks - lo - block);
+					size_t hn = mpn::normalizedSize(hi, hs);
+					if(hn == 0)continue;
+					size_t len = block + hs;
+					if(pn >= hn)mpn::mul(tmp, p.limbs(), pn, hi, hn);
+					else mpn::mul(tmp, hi, hn, p.limbs(), pn);
+					mpn::zero(tmp + pn + hn, len - pn - hn);
+					mpn::add(tmp, tmp, len, r + lo, block);
+					mpn::copy(r + lo, tmp, len);
+				}
+			});
+		}
+		ret.trim();
+		ret.signum = mpn::isZero(ret.limbs(), ret.size()) ? 1 : sign;
+		return ret;
+	}
+	//Number of leading zero bits in the whole limb storage
+	inline size_t bitscanForward()const{
+		size_t n = mpn::normalizedSize(limbs(), size());
+		if(n == 0)return size() * 64 + 64;
+		return (size() - n) * 64 + _leading_zeros(data[n - 1]);
+	}
+	//Number of trailing zero bits
+	inline size_t bitscanReverse()const{
+		size_t i = 0;
+		while(i < size() && data[i] == 0)++i;
+		if(i == size())return i * 64 + 64;
+		return i * 64 + _trailing_zeros(data[i]);
+	}
+	inline size_t bitLength()const{
+		return mpn::bitLength(limbs(), size());
+	}
+	inline bool testBit(size_t i)const{
+		return i / 64 < size() && ((data[i / 64] >> (i % 64)) & 1);
+	}
+	//count <= 64 bits starting at bit pos, as an integer
+	inline uint64_t extractBits(size_t pos, unsigned int count)const{
+		size_t limb = pos / 64;
+		unsigned int sh = pos % 64;
+		if(limb >= size() || count == 0)return 0;
+		uint64_t ret = data[limb] >> sh;
+		if(sh && limb + 1 < size())ret |= data[limb + 1] << (64 - sh);
+		if(count < 64)ret &= (1ULL << count) - 1;
+		return ret;
+	}
+	//Compares the magnitudes, ignoring the signs
+	inline int compareMagnitude(const BigInt& o)const{
+		return compareMagnitude(o.view());
+	}
+	inline int compareMagnitude(const BigIntView& o)const{
+		return mpn::cmp(limbs(), size(), o.limbs(), o.size());
+	}
+	inline int compare(const BigInt& o)const{
+		return view().compare(o.view());
+	}
+	inline int compare(const BigIntView& o)const{
+		return view().compare(o);
+	}
+	inline bool operator<(const BigInt& o)const{
+		return compare(o) < 0;
+	}
+	inline bool operator>(const BigInt& o)const{
+		return compare(o) > 0;
+	}
+	inline bool operator<=(const BigInt& o)const{
+		return compare(o) <= 0;
+	}
+	inline bool operator>=(const BigInt& o)const{
+		return compare(o) >= 0;
+	}
+	inline bool operator==(const BigInt& o)const{
+		if(signum != o.signum)return compare(o) == 0;
+		size_t n = mpn::normalizedSize(limbs(), size());
+		return n == mpn::normalizedSize(o.limbs(), o.size()) && mpn::equal_n(limbs(), o.limbs(), n);
+	}
+	inline bool operator==(uint64_t o)const{
+		return mpn::normalizedSize(limbs(), size()) <= 1 && data[0] == o;
+	}
+	inline bool isZero()const{
+		return mpn::isZero(limbs(), size());
+	}
+	//The low 128 bits of the magnitude
+	inline lui low128()const{
+		return size() > 1 ? ((lui)data[1] << 64) | data[0] : (lui)data[0];
+	}
+	inline void setZero(){
+		mpn::zero(limbs(), size());
+	}
+
+	inline BigInt& trim(){
+		data.resize(std::max<size_t>(1, mpn::normalizedSize(limbs(), size())));
+		return *this;
+	}
+
+	inline BigInt div(uint64_t d)const{
+		BigInt ret = *this;
+		ret.div(d);
+		return ret;
+	}
+	inline BigInt& div(uint64_t d){
+		if(size() > 1)mpn::divrem_1(limbs(), limbs(), size(), mpn::LimbDivisor(d));
+		else data[0] /= d;
+		return *this;
+	}
+	inline uint64_t mod(uint64_t m)const{
+		return view().mod(m);
+	}
+	//Division by a limb whose reciprocal is computed once and reused
+	inline BigInt div(const mpn::LimbDivisor& d)const{
+		BigInt ret = *this;
+		ret.div(d);
+		return ret;
+	}
+	inline BigInt& div(const mpn::LimbDivisor& d){
+		mpn::divrem_1(limbs(), limbs(), size(), d);
+		return *this;
+	}
+	inline uint64_t mod(const mpn::LimbDivisor& d)const{
+		return view().mod(d);
+	}
+	//Quotient truncated toward zero and remainder of the magnitude by a limb, both from a single sweep
+	inline std::pair<BigInt, uint64_t> divmodSmall(uint64_t d)const{
+		return divmodSmall(mpn::LimbDivisor(d));
+	}
+	inline std::pair<BigInt, uint64_t> divmodSmall(const mpn::LimbDivisor& d)const{
+		BigInt q(size(), 0);
+		uint64_t r = mpn::divrem_1(q.limbs(), limbs(), size(), d);
+		q.trim();
+		q.signum = q.isZero() ? 1 : signum;
+		return {std::move(q), r};
+	}
+	//Quotient and remainder truncated toward zero, the remainder takes the sign of this
+	inline std::pair<BigInt, BigInt> divmod(const BigInt& o)const{
+		assert(!o.isZero());
+		size_t an = mpn::normalizedSize(limbs(), size());
+		size_t dn = mpn::normalizedSize(o.limbs(), o.size());
+		if(an < dn)return {BigInt(0), *this};
+		BigInt q(an - dn + 1, 0), r(dn, 0);
+		if(an == 2 && dn == 2){
+			//Both fit in 128 bits and the quotient in one limb (single limb divisors have divrem_1)
+			lui x = low128(), y = o.low128();
+			q.limbAt(0) = (uint64_t)(x / y);
+			lui rem = x % y;
+			r.limbAt(0) = (uint64_t)rem;
+			r.limbAt(1) = (uint64_t)(rem >> 64);
+		}
+		else mpn::divrem(q.limbs(), r.limbs(), limbs(), an, o.limbs(), dn);
+		q.trim();
+		r.trim();
+		q.signum = q.isZero() ? 1 : signum * o.signum;
+		r.signum = r.isZero() ? 1 : signum;
+		return {std::move(q), std::move(r)};
+	}
+
+	inline BigInt& bitshiftLeft(int c){
+		if(c < 0)return bitshiftRight(-c);
+		unsigned int sh = c % 64;
+		size_t jmp = c / 64;
+		if(jmp >= size()){setZero();return *this;}
+		uint64_t* r = limbs();
+		if(sh)mpn::lshift(r + jmp, r, size() - jmp, sh);
+		else mpn::copy(r + jmp, r, size() - jmp);
+		mpn::zero(r, jmp);
+		return *this;
+	}
+
+	inline BigInt& bitshiftLeft_expand(int c){
+		if(c < 0)return bitshiftRight(-c);
+		size_t needed = (bitLength() + c + 63) / 64;
+		if(needed > size())data.resize(needed, 0);
+		return bitshiftLeft(c);
+	}
+
+	inline BigInt& bitshiftRight(int c){
+		if(c < 0)return bitshiftLeft(-c);
+		unsigned int sh = c % 64;
+		size_t jmp = c / 64;
+		if(jmp >= size()){setZero();return *this;}
+		uint64_t* r = limbs();
+		if(sh)mpn::rshift(r, r + jmp, size() - jmp, sh);
+		else mpn::copy(r, r + jmp, size() - jmp);
+		mpn::zero(r + size() - jmp, jmp);
+		return *this;
+	}
+	inline BigInt operator<<(int c)const{
+		BigInt ret = *this;
+		ret.bitshiftLeft(c);
+		return ret;
+	}
+
+	inline BigInt operator>>(int c)const{
+		BigInt ret = *this;
+		ret.bitshiftRight(c);
+		return ret;
+	}
+
+	inline BigInt& operator<<=(int c){
+		return bitshiftLeft(c);
+	}
+
+	inline BigInt& operator>>=(int c){
+		return bitshiftRight(c);
+	}
+
+	inline BigInt& operator&=(const BigInt& o){
+		size_t n = std::min(size(), o.size());
+		uint64_t* r = limbs();
+		mpn::and_n(r, r, o.limbs(), n);
+		return *this;
+	}
+	inline BigInt& operator|=(const BigInt& o){
+		size_t n = std::min(size(), o.size());
+		uint64_t* r = limbs();
+		mpn::ior_n(r, r, o.limbs(), n);
+		return *this;
+	}
+	inline BigInt& operator^=(const BigInt& o){
+		size_t n = std::min(size(), o.size());
+		uint64_t* r = limbs();
+		mpn::xor_n(r, r, o.limbs(), n);
+		return *this;
+	}
+	inline BigInt operator&(const BigInt& o)const{
+		BigInt ret(*this);
+		ret &= o;
+		return ret;
+	}
+	inline BigInt operator|(const BigInt& o)const{
+		BigInt ret(*this);
+		ret |= o;
+		return ret;
+	}
+	inline BigInt operator^(const BigInt& o)const{
+		BigInt ret(*this);
+		ret ^= o;
+		return ret;
+	}
+	inline BigInt& cut(size_t chunks){
+		if(size() > chunks)data.resize(chunks);
+		return *this;
+	}
+	inline int bitDifference(const BigInt& o){
+		return (int)bitLength() - (int)o.bitLength();
+	}
+	inline BigInt& chunkshiftLeft(int c){
+		if(c < 0)return chunkshiftRight(-c);
+		if((unsigned int)c >= size()){setZero();return *this;}
+		mpn::copy(limbs() + c, limbs(), size() - c);
+		mpn::zero(limbs(), c);
+		return *this;
+	}
+
+	inline BigInt& chunkshiftRight(int c){
+		if(c < 0)return chunkshiftLeft(-c);
+		if((unsigned int)c >= size()){setZero();return *this;}
+		mpn::copy(limbs(), limbs() + c, size() - c);
+		mpn::zero(limbs() + size() - c, c);
+		return *this;
 	}
 	inline BigInt bitshiftLeft(int c)const{
 		if(c < 0)return bitshiftRight(-c);
@@ -1134,223 +3342,1610 @@ struct BigInt{
 		ret.adda(o);
 		return ret;
 	}
-	
+
 	inline BigInt& adda(const BigInt& o){
-		while(size() < o.size())data.push_front(0);
-		bool carry = 0;
-		auto it1 = rbegin();
-		auto it2 = o.rbegin();
-		while(it1 != rend() && it2 != o.rend()){
-			carry = _adc_u64(*it1, *it2 + carry, (unsigned long long*)(&(*it1)));
-			carry |= (*it2 + carry) == 0 && *it2;
-			++it1;
-			++it2;
-		}
-		while(it1 != rend() && carry){
-			carry = _adc_u64(*it1, carry, (unsigned long long*)(&(*it1)));
-			++it1;
-		}
-		if(carry)data.push_front(1);
+		return adda(o.view());
+	}
+	//Magnitude arithmetic, o must not point into this
+	inline BigInt& adda(const BigIntView& o){
+		size_t on = o.size();
+		if(size() < on)data.resize(on, 0);
+		uint64_t carry = mpn::add(limbs(), limbs(), size(), o.limbs(), on);
+		if(carry)data.push_back(carry);
 		return *this;
 	}
 	inline BigInt& suba(const BigInt& o){
-		assert((*this) >= (o));
-		bool carry = 0;
-		auto it1 = rbegin();
-		auto it2 = o.rbegin();
-		while(it1 != rend() && it2 != o.rend()){
-			carry = _sbc_u64(*it1 - carry, *it2, (unsigned long long*)(&(*it1)));
-			if(!carry)carry = ((*it1 - carry) == std::numeric_limits<uint64_t>::max());
-			++it1;++it2;
-		}
-		while(it1 != rend() && carry){
-			carry = _sbc_u64(*it1, carry, (unsigned long long*)(&(*it1)));
-			++it1;
+		return suba(o.view());
+	}
+	inline BigInt& suba(const BigIntView& o){
+		assert(compareMagnitude(o) >= 0);
+		size_t on = std::max<size_t>(1, mpn::normalizedSize(o.limbs(), o.size()));
+		if(size() < on)data.resize(on, 0);
+		mpn::sub(limbs(), limbs(), size(), o.limbs(), on);
+		return *this;
+	}
+	inline BigInt& moda(const BigInt& o){
+		return moda(o.view());
+	}
+	inline BigInt& moda(const BigIntView& o){
+		assert(!o.isZero());
+		if(compareMagnitude(o) < 0)return *this;
+		size_t an = mpn::normalizedSize(limbs(), size());
+		size_t dn = o.normalizedSize();
+		if(an <= 2){
+			lui r = low128() % (dn > 1 ? ((lui)o[1] << 64) | o[0] : (lui)o[0]);
+			data.resize(2);
+			data[0] = (uint64_t)r;
+			data[1] = (uint64_t)(r >> 64);
 		}
+		else{
+			//The remainder is written after the dividend has been consumed, so it can overwrite this in place
+			mpn::TempLimbs q(an - dn + 1);
+			mpn::divrem(q, limbs(), limbs(), an, o.limbs(), dn);
+			data.resize(dn);
+		}
+		trim();
+		//Like divmod, a zero remainder is positive
+		if(isZero())signum = 1;
 		return *this;
 	}
-	inline BigInt& moda(const BigInt& o){
-		assert(!o.isZero());
-		if(o > *this)return *this;
-		BigInt mo = o;
-		mo = o;
-		int bd = bitDifference(o);
-		mo.bitshiftLeft_expand(bd);
-		if(mo > *this)mo.bitshiftRight(1);
-		this->suba(mo);
-		if(*this < o)return *this;
-		while(true){
-			bd = mo.bitDifference(*this);
-			mo >>= bd;
-			mo.trim();
-			if(mo > *this)mo >>= 1;
-			this->suba(mo);
-			if(*this < o)return *this;
+	inline bool even()const{
+		return !(data[0] & 1);
+	}
+	inline BigInt modPow(const BigInt& o, const BigInt& mod)const;
+	inline BigInt modPow(const BigInt& o, const MontgomeryContext& ctx)const;
+	//bases[i]^exps[i] mod mod for every i, exps holds one exponent per base or a single one for all of them
+	static inline std::vector<BigInt> modPowBatch(const std::vector<BigInt>& bases, const std::vector<BigInt>& exps, const BigInt& mod);
+	inline BigInt square()const{
+		size_t an = std::max<size_t>(1, mpn::normalizedSize(limbs(), size()));
+		BigInt result(2 * an, 0);
+		if(an == 1)mulLimbs(result.limbs(), limbs(), 1, limbs(), 1);
+		else mpn::sqr(result.limbs(), limbs(), an);
+		result.trim();
+		return result;
+	}
+	//|this| |o|, the magnitude like adda, suba and moda; a * b, *= and mul give the signed product
+	inline BigInt mult(const BigInt& o)const{
+		if(&o == this)return square();
+		return mult(o.view());
+	}
+	inline BigInt mult(const BigIntView& o)const{
+		size_t an = std::max<size_t>(1, mpn::normalizedSize(limbs(), size()));
+		size_t bn = std::max<size_t>(1, mpn::normalizedSize(o.limbs(), o.size()));
+		BigInt result(an + bn, 0);
+		mulLimbs(result.limbs(), limbs(), an, o.limbs(), bn);
+		result.trim();
+		return result;
+	}
+
+	/*
+	 * Signed three operand arithmetic into dst, which keeps and reuses its limb storage. dst may be one of
+	 * the operands; only a product over one of its own operands needs scratch space.
+	 */
+	static inline BigInt& add(BigInt& dst, const BigInt& a, const BigInt& b){
+		dst.data.reserve(std::max(a.size(), b.size()) + 1);
+		addLimbs(dst, a.limbs(), a.size(), a.signum, b.limbs(), b.size(), b.signum);
+		return dst;
+	}
+	static inline BigInt& sub(BigInt& dst, const BigInt& a, const BigInt& b){
+		dst.data.reserve(std::max(a.size(), b.size()) + 1);
+		addLimbs(dst, a.limbs(), a.size(), a.signum, b.limbs(), b.size(), -b.signum);
+		return dst;
+	}
+	static inline BigInt& mul(BigInt& dst, const BigInt& a, const BigInt& b){
+		size_t an = std::max<size_t>(1, mpn::normalizedSize(a.limbs(), a.size()));
+		size_t bn = std::max<size_t>(1, mpn::normalizedSize(b.limbs(), b.size()));
+		int sign = a.signum * b.signum;
+		if(&dst == &a || &dst == &b){
+			mpn::TempLimbs t(an + bn);
+			mulLimbs(t, a.limbs(), an, b.limbs(), bn);
+			dst.data.resize(an + bn);
+			mpn::copy(dst.limbs(), t, an + bn);
+		}
+		else{
+			dst.data.resize(an + bn);
+			mulLimbs(dst.limbs(), a.limbs(), an, b.limbs(), bn);
+		}
+		dst.trim();
+		dst.signum = dst.isZero() ? 1 : sign;
+		return dst;
+	}
+	static inline BigInt& sqr(BigInt& dst, const BigInt& a){
+		return mul(dst, a, a);
+	}
+	//Views may only point into dst's limbs for mul
+	static inline BigInt& add(BigInt& dst, const BigIntView& a, const BigIntView& b){
+		dst.data.reserve(std::max(a.size(), b.size()) + 1);
+		addLimbs(dst, a.limbs(), a.size(), a.signum, b.limbs(), b.size(), b.signum);
+		return dst;
+	}
+	static inline BigInt& sub(BigInt& dst, const BigIntView& a, const BigIntView& b){
+		dst.data.reserve(std::max(a.size(), b.size()) + 1);
+		addLimbs(dst, a.limbs(), a.size(), a.signum, b.limbs(), b.size(), -b.signum);
+		return dst;
+	}
+	static inline BigInt& mul(BigInt& dst, const BigIntView& a, const BigIntView& b){
+		size_t an = std::max<size_t>(1, a.normalizedSize());
+		size_t bn = std::max<size_t>(1, b.normalizedSize());
+		int sign = a.signum * b.signum;
+		mpn::TempLimbs t(an + bn);
+		mulLimbs(t, a.limbs(), an, b.limbs(), bn);
+		dst.data.resize(an + bn);
+		mpn::copy(dst.limbs(), t, an + bn);
+		dst.trim();
+		dst.signum = dst.isZero() ? 1 : sign;
+		return dst;
+	}
+	/*
+	 * Results written into the n limbs of a mutable view, zero padded, for in place arithmetic on buffers owned
+	 * elsewhere. The result has to fit in n limbs. For add and sub an operand may start at dst's first limb.
+	 */
+	static inline MutableBigIntView& add(MutableBigIntView& dst, const BigIntView& a, const BigIntView& b){
+		addLimbs(dst, a.limbs(), a.size(), a.signum, b.limbs(), b.size(), b.signum);
+		return dst;
+	}
+	static inline MutableBigIntView& sub(MutableBigIntView& dst, const BigIntView& a, const BigIntView& b){
+		addLimbs(dst, a.limbs(), a.size(), a.signum, b.limbs(), b.size(), -b.signum);
+		return dst;
+	}
+	//dst may overlap a or b, the product then goes through scratch space
+	static inline MutableBigIntView& mul(MutableBigIntView& dst, const BigIntView& a, const BigIntView& b){
+		size_t an = std::max<size_t>(1, a.normalizedSize());
+		size_t bn = std::max<size_t>(1, b.normalizedSize());
+		int sign = a.signum * b.signum;
+		std::less<const uint64_t*> before;
+		auto overlaps = [&](const BigIntView& v){return before(v.limbs(), dst.limbs() + dst.size()) && before(dst.limbs(), v.limbs() + v.size());};
+		if(dst.size() >= an + bn && !overlaps(a) && !overlaps(b)){
+			mulLimbs(dst.limbs(), a.limbs(), an, b.limbs(), bn);
+			mpn::zero(dst.limbs() + an + bn, dst.size() - an - bn);
 		}
-		return *this;
+		else{
+			mpn::TempLimbs t(an + bn);
+			mulLimbs(t, a.limbs(), an, b.limbs(), bn);
+			size_t rn = mpn::normalizedSize(t, an + bn);
+			assert(rn <= dst.size());
+			mpn::copy(dst.limbs(), t, rn);
+			mpn::zero(dst.limbs() + rn, dst.size() - rn);
+		}
+		dst.signum = dst.isZero() ? 1 : sign;
+		return dst;
 	}
-	inline bool even(){
-		return !(*rbegin() & 1);
+	//r = a * b for normalized sizes in either order, r must not overlap a or b
+	static inline void mulLimbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn){
+		if(an == 1 && bn == 1){
+			lui p = (lui)a[0] * b[0];
+			r[0] = (uint64_t)p;
+			r[1] = (uint64_t)(p >> 64);
+		}
+		else if(an >= bn)mpn::mul(r, a, an, b, bn);
+		else mpn::mul(r, b, bn, a, an);
 	}
-	inline BigInt modPow(BigInt o, const BigInt& mod)const{
-		BigInt t = *this;
-		BigInt odd(1);
-		while(true){
-			if(o.even()){
-				t = t.mult(t);
-				t.trim();
-				t.moda(mod);
-				o.div(2);
+	/*
+	 * dst = asign |a| + bsign |b|. dst has room for max(an, bn) + 1 limbs already, and a or b may only lie in
+	 * dst's limbs when they start at the same place.
+	 */
+	static inline void addLimbs(BigInt& dst, const uint64_t* a, size_t an, int asign, const uint64_t* b, size_t bn, int bsign){
+		an = std::max<size_t>(1, mpn::normalizedSize(a, an));
+		bn = std::max<size_t>(1, mpn::normalizedSize(b, bn));
+		if(asign == bsign){
+			if(an < bn){
+				std::swap(a, b);
+				std::swap(an, bn);
 			}
-			else{
-				odd = odd.mult(t);
-				odd.moda(mod);
-				odd.trim();
-				t.trim();
-				t.moda(mod);
-				o.suba(BigInt(1));
+			assert(dst.data.capacity() > an);
+			//Growing dst only zeroes limbs that neither operand still needs
+			dst.data.resize(an + 1);
+			dst.data[an] = mpn::add(dst.limbs(), a, an, b, bn);
+		}
+		else{
+			if(mpn::cmp(a, an, b, bn) < 0){
+				std::swap(a, b);
+				std::swap(an, bn);
+				asign = bsign;
 			}
-			//::cout << "Reduced" << std::endl;
-			o.trim();
-			if(o == 1){t = t.mult(odd);t.moda(mod);return t;}
+			dst.data.resize(an);
+			mpn::sub(dst.limbs(), a, an, b, bn);
 		}
+		dst.trim();
+		dst.signum = dst.isZero() ? 1 : asign;
 	}
-	inline BigInt mult(const BigInt& o)const{
-		BigInt result(size() + o.size() + 1,0);
-		BigInt temp(size() + o.size() + 1,0);
-		int p = 0;
-		for(auto it1 = rbegin();it1 != rend();it1++){
-			auto it = temp.rbegin();
-			uint64_t carry = 0;
-			for(auto it2 = o.rbegin();it2 != o.rend();it2++){
-				uint64_t hi;
-				uint64_t lo = mulx_u64(*it1, *it2, (unsigned long long*)&hi);
-				bool ac = _adc_u64(lo, carry, (unsigned long long*)(&(*(it++))));
-				carry = hi + ac;
+	static inline void addLimbs(MutableBigIntView& dst, const uint64_t* a, size_t an, int asign, const uint64_t* b, size_t bn, int bsign){
+		an = std::max<size_t>(1, mpn::normalizedSize(a, an));
+		bn = std::max<size_t>(1, mpn::normalizedSize(b, bn));
+		if(mpn::cmp(a, an, b, bn) < 0){
+			std::swap(a, b);
+			std::swap(an, bn);
+			std::swap(asign, bsign);
+		}
+		assert(dst.size() >= an);
+		uint64_t* r = dst.limbs();
+		if(asign == bsign){
+			uint64_t carry = mpn::add(r, a, an, b, bn);
+			mpn::zero(r + an, dst.size() - an);
+			if(carry){
+				assert(dst.size() > an);
+				r[an] = carry;
 			}
-			if(carry)(*it) += carry;
-			temp.chunkshiftLeft(p++);
-			result.adda(temp);
-			temp.setZero();
 		}
-		result.trim();
-		return result;
+		else{
+			mpn::sub(r, a, an, b, bn);
+			mpn::zero(r + an, dst.size() - an);
+		}
+		dst.signum = mpn::isZero(r, dst.size()) ? 1 : asign;
+	}
+	inline BigInt& operator+=(const BigInt& o){return add(*this, *this, o);}
+	inline BigInt& operator-=(const BigInt& o){return sub(*this, *this, o);}
+	inline BigInt& operator*=(const BigInt& o){return mul(*this, *this, o);}
+	template<typename E>
+	inline BigInt& operator+=(const BigIntExpr<E>& e){
+		e.self().addTo(*this, 1);
+		return *this;
+	}
+	template<typename E>
+	inline BigInt& operator-=(const BigIntExpr<E>& e){
+		e.self().addTo(*this, -1);
+		return *this;
 	}
-	
+
 	inline BigInt multOld(const BigInt& o)const{
-		BigInt result(size() + o.size() + 1,0);
-		BigInt temp(size() + o.size() + 1,0);
-		int p = 0;
-		for(auto it1 = rbegin();it1 != rend();it1++){
-			auto it = temp.rbegin();
+		BigInt result(size() + o.size(), 0);
+		uint64_t* r = result.limbs();
+		for(size_t i = 0;i < size();i++){
 			lui carry = 0;
-			for(auto it2 = o.rbegin();it2 != o.rend();it2++){
-				lui prod = ((lui)*it1) * (*it2);
+			for(size_t j = 0;j < o.size();j++){
+				lui prod = ((lui)data[i]) * o.data[j];
+				prod += r[i + j];
 				prod += carry;
-				*(it++) = (uint64_t)prod;
+				r[i + j] = (uint64_t)prod;
 				carry = (prod >> 64);
 			}
-			if(carry)(*it) += carry;
-			temp.chunkshiftLeft(p++);
-			result.adda(temp);
-			temp.setZero();
+			r[i + o.size()] = (uint64_t)carry;
 		}
 		result.trim();
 		return result;
 	}
-	
+
 	inline std::string rawString(bool flag = false)const{
 		std::string s = "";
-		for(unsigned int i = 0;i < size();i++){
+		for(size_t i = size();i-- > 0;){
 			if(data[i])flag = true;
 			if(flag)
 				s += data[i] == 0 ? "0" : std::to_string(data[i]);
-			if(flag)if(i < size() - 1)s += "|";
+			if(flag)if(i > 0)s += "|";
 		}
 		return s;
 	}
+	//All 64 bits of every limb, most significant first and including leading zeros
 	inline std::string bitString()const{
-		auto it = begin();
-		std::string ret = "";
-		//std::cout << size() << "; " << std::flush;
-		while(it != end()){
-			std::bitset<64> bits(*it);
-			for(unsigned int i = 0;i < 64;i++){
-				ret += chars.at(((*it) & (1ULL << (64 - i))) != 0);
-			}
-			++it;
+		std::string ret(64 * size(), '0');
+		size_t k = 0;
+		for(auto it = rbegin();it != rend();++it){
+			for(int i = 63;i >= 0;i--)ret[k++] = chars[(*it >> i) & 1];
 		}
 		return ret;
 	}
 	inline std::string hexString()const{
-		auto it = begin();
-		bool flag = false;
-		std::string ret = "";
-		while(it != end()){
-			uint64_t curr(*it);
-			if(curr == 0){++it;continue;}
-			char ccurr[17];
-			singleHex(ccurr, curr);
-			if(flag){
-				ret += ccurr;
-				++it;
-				continue;
+		return powerOfTwoString(view(), 4);
+	}
+	/*
+	 * Digits of the magnitude in base 2^bits for bits <= 5, most significant first without leading zeros.
+	 * Every digit is read straight from the limbs, so the conversion is linear.
+	 */
+	static inline std::string powerOfTwoString(const BigIntView& v, unsigned int bits){
+		assert(bits >= 1 && bits <= 5);
+		size_t n = v.normalizedSize();
+		if(n == 0)return std::string(1, '0');
+		size_t digits = (mpn::bitLength(v.limbs(), n) + bits - 1) / bits;
+		std::string ret(digits, '0');
+		char* out = &ret[0] + digits;
+		const uint64_t mask = ((uint64_t)1 << bits) - 1;
+		if(64 % bits == 0){
+			//Digits never straddle limbs
+			const unsigned int per = 64 / bits;
+			for(size_t i = 0;i < n;i++){
+				uint64_t x = v[i];
+				unsigned int count = i + 1 < n ? per : (unsigned int)(digits - i * per);
+				for(unsigned int j = 0;j < count;j++, x >>= bits)*--out = chars[x & mask];
 			}
-			flag = true;
-			size_t start = 0;
-			while(ccurr[start] == '0')++start;
-			ret += (char*)(ccurr + start);
-			++it;
+			return ret;
+		}
+		for(size_t pos = 0;out != &ret[0];pos += bits){
+			size_t limb = pos / 64;
+			unsigned int sh = pos % 64;
+			uint64_t x = v[limb] >> sh;
+			if(sh + bits > 64 && limb + 1 < n)x |= v[limb + 1] << (64 - sh);
+			*--out = chars[x & mask];
 		}
 		return ret;
 	}
-	inline std::string toString()const{
-		if(isZero())return std::to_string(0);
-		std::deque<char> c_str;
-		const uint64_t q = 1000000000000000000ULL;
-		BigInt diver = *this;
-		while(!diver.isZero()){
-			std::string frac = std::to_string(diver.mod(q));
-			int a = 0;
-			for(auto it = frac.rbegin();it != frac.rend();it++){
-				c_str.push_front(*it);
-				a++;
-			}
-			while(a < 18){
-				c_str.push_front('0');
-				a++;
+	//RFC 4648 base64 of the big endian bytes of the magnitude (at least one), padded with '=' unless url
+	static inline std::string toBase64(const BigIntView& v, bool url = false){
+		size_t n = v.normalizedSize();
+		size_t bytes = std::max<size_t>(1, (mpn::bitLength(v.limbs(), n) + 7) / 8);
+		//Byte i counted from the most significant one
+		auto byte = [&](size_t i)->unsigned int{
+			size_t j = bytes - 1 - i;
+			return j / 8 < n ? (unsigned int)(v[j / 8] >> (8 * (j % 8))) & 0xff : 0;
+		};
+		const char* alphabet = base64Chars[url];
+		size_t tail = bytes % 3;
+		std::string ret(bytes / 3 * 4 + (tail ? (url ? tail + 1 : 4) : 0), '=');
+		char* out = &ret[0];
+		size_t i = 0;
+		for(;i + 3 <= bytes;i += 3, out += 4){
+			unsigned int w = byte(i) << 16 | byte(i + 1) << 8 | byte(i + 2);
+			out[0] = alphabet[w >> 18];
+			out[1] = alphabet[(w >> 12) & 63];
+			out[2] = alphabet[(w >> 6) & 63];
+			out[3] = alphabet[w & 63];
+		}
+		if(tail){
+			unsigned int w = byte(i) << 16 | (tail == 2 ? byte(i + 1) << 8 : 0);
+			out[0] = alphabet[w >> 18];
+			out[1] = alphabet[(w >> 12) & 63];
+			if(tail == 2)out[2] = alphabet[(w >> 6) & 63];
+		}
+		return ret;
+	}
+	inline std::string toBase64(bool url = false)const{
+		return toBase64(view(), url);
+	}
+	//Limb count below which decimal conversion peels off 18 digits at a time instead of splitting
+	static constexpr size_t decimalBasecaseLimbs = 30;
+	//(10^digits)^(2^k) for 18 digit (printing) or 19 digit (parsing) chunks, computed once and shared by all conversions
+	static inline const BigInt& decimalPower(size_t k, unsigned int digits = 18){
+		assert(digits == 18 || digits == 19);
+		static std::deque<BigInt> powers[2];
+		static std::mutex lock;
+		std::unique_lock<std::mutex> guard(lock);
+		std::deque<BigInt>& p = powers[digits - 18];
+		if(p.empty())p.emplace_back(digits == 18 ? 1000000000000000000ULL : 10000000000000000000ULL);
+		while(p.size() <= k){
+			//A parallel square runs pool tasks on this thread that may ask for a power themselves, so square unlocked
+			const BigInt& last = p.back();
+			size_t n = p.size();
+			guard.unlock();
+			//The cache outlives any allocator set as the default, so it keeps its limbs in malloc
+			BigInt next(&mallocLimbAllocator());
+			sqr(next, last);
+			guard.lock();
+			if(p.size() == n)p.push_back(std::move(next));
+		}
+		return p[k];
+	}
+	//Upper bound for the number of decimal digits
+	inline size_t decimalDigitsBound()const{
+		return decimalDigitsBound(view());
+	}
+	//Writes exactly width digits of a < 10^width into out, zero padded on the left; a is destroyed
+	static inline void decimalDigits(char* out, size_t width, uint64_t* a, size_t an){
+		static const mpn::LimbDivisor q(1000000000000000000ULL);
+		an = mpn::normalizedSize(a, an);
+		if(an <= decimalBasecaseLimbs){
+			char* p = out + width;
+			while(an > 0 && p > out){
+				uint64_t chunk = mpn::divrem_1(a, a, an, q);
+				an = mpn::normalizedSize(a, an);
+				if(p - out >= 18){
+					//The halves have no dependency on each other
+					p -= 18;
+					nineDigits(p, (uint32_t)(chunk / 1000000000));
+					nineDigits(p + 9, (uint32_t)(chunk % 1000000000));
+					continue;
+				}
+				for(int i = 0;i < 18 && p > out;i++){
+					*(--p) = (char)('0' + chunk % 10);
+					chunk /= 10;
+				}
 			}
-			diver.div(q);
+			std::fill(out, p, '0');
+			return;
+		}
+		size_t k = 0;
+		while(36 * ((size_t)2 << k) <= width)++k;
+		size_t low = 18 * ((size_t)1 << k);
+		const BigInt& p = decimalPower(k);
+		size_t pn = p.size();
+		if(an < pn){
+			std::fill(out, out + width - low, '0');
+			decimalDigits(out + width - low, low, a, an);
+			return;
+		}
+		mpn::TempLimbs tmp(an - pn + 1 + pn);
+		uint64_t* quot = tmp;
+		uint64_t* rem = quot + an - pn + 1;
+		mpn::divrem(quot, rem, a, an, p.limbs(), pn);
+		//Both halves write to their own digits and limbs, so they can be converted concurrently
+		TaskGroup tasks(mpn::parallelPoolFor(pn));
+		tasks.run([&]{decimalDigits(out, width - low, quot, an - pn + 1);});
+		decimalDigits(out + width - low, low, rem, pn);
+		tasks.wait();
+	}
+	//Writes the decimal digits to [first, last) and returns the end, or nullptr if they do not fit
+	inline char* toChars(char* first, char* last)const{
+		return toChars(view(), first, last);
+	}
+	static inline size_t decimalDigitsBound(const BigIntView& v){
+		return (v.bitLength() * 1234 >> 12) + 1;
+	}
+	static inline char* toChars(const BigIntView& v, char* first, char* last){
+		size_t width = decimalDigitsBound(v);
+		std::unique_ptr<char[]> spill;
+		char* out = first;
+		if((size_t)(last - first) < width){
+			spill.reset(new char[width]);
+			out = spill.get();
 		}
-		auto it = c_str.begin();
-		while(*(it) == '0')++it;
-		return std::string(it, c_str.end());
+		//decimalDigits consumes its input
+		mpn::TempLimbs a(std::max<size_t>(1, v.size()));
+		mpn::copy(a, v.limbs(), v.size());
+		decimalDigits(out, width, a, v.size());
+		size_t lead = 0;
+		while(lead + 1 < width && out[lead] == '0')++lead;
+		size_t len = width - lead;
+		if((size_t)(last - first) < len)return nullptr;
+		std::memmove(first, out + lead, len);
+		return first + len;
+	}
+	inline std::string toString()const{
+		return view().toString();
 	}
-	
+
 	inline std::string toString(unsigned int base)const{
+		if(base < 2 || base > chars.size())throw std::invalid_argument("BigInt: base " + std::to_string(base) + " is not in [2, 36]");
 		if(isZero())return std::to_string(0);
-		if(base == 2)return bitString();
 		if(base == 10)return toString();
-		if(base == 16)return hexString();
+		if(!(base & (base - 1)))return powerOfTwoString(view(), (unsigned int)_trailing_zeros(base));
 		std::vector<char> c_str;
 		c_str.reserve(size() * (unsigned int)(64.0 * std::log(2) / std::log((double)base)));
-		BigInt diver = *this;
-		while(!diver.isZero()){
-			c_str.push_back(chars.at(diver.mod(base)));
-			diver.div(base);
+		//Sweeps divide in place like divmodSmall by base^k, the largest power in a limb, and yield k digits each
+		uint64_t big = base;
+		unsigned int k = 1;
+		while(big <= ~(uint64_t)0 / base){
+			big *= base;
+			++k;
+		}
+		const mpn::LimbDivisor d(big);
+		size_t an = mpn::normalizedSize(limbs(), size());
+		mpn::TempLimbs a(an);
+		mpn::copy(a, limbs(), an);
+		while(an > 0){
+			uint64_t chunk = mpn::divrem_1(a, a, an, d);
+			an = mpn::normalizedSize(a, an);
+			//The most significant chunk stops at its last nonzero digit
+			for(unsigned int i = 0;i < k && (an > 0 || chunk);i++){
+				c_str.push_back(chars.at(chunk % base));
+				chunk /= base;
+			}
 		}
 		return std::string(c_str.rbegin(), c_str.rend());
 	}
+	/*
+	 * Binary format (version 1), little endian and self delimiting, so values can follow each other in a stream:
+	 *   header byte: version << 4 | varint << 1 | negative
+	 *   limbs:  LEB128 limb count n followed by the n limbs of the magnitude, 8 little endian bytes each
+	 *   varint: the magnitude as one LEB128 number, 7 bits per byte, which is shorter for small values
+	 * Leading zero limbs are not written and zero is never negative. On little endian hosts the limbs are
+	 * copied straight from and into the limb storage.
+	 */
+	static constexpr unsigned char binaryVersion = 1;
+	static inline size_t varintSize(uint64_t v){
+		size_t n = 1;
+		for(;v >= 0x80;v >>= 7)n++;
+		return n;
+	}
+	static inline unsigned char* putVarint(unsigned char* out, uint64_t v){
+		for(;v >= 0x80;v >>= 7)*out++ = (unsigned char)(v | 0x80);
+		*out++ = (unsigned char)v;
+		return out;
+	}
+	//Converts limbs between host order and little endian in place
+	static inline void littleEndianLimbs(uint64_t* a, size_t n){
+#ifdef BIGINT_BIG_ENDIAN
+		for(size_t i = 0;i < n;i++)a[i] = __builtin_bswap64(a[i]);
+#else
+		(void)a;
+		(void)n;
+#endif
+	}
+	static inline size_t binarySize(const BigIntView& v, BigIntFormat f = BigIntFormat::limbs){
+		size_t n = v.normalizedSize();
+		if(f == BigIntFormat::limbs)return 1 + varintSize(n) + 8 * n;
+		return 1 + std::max<size_t>(1, (mpn::bitLength(v.limbs(), n) + 6) / 7);
+	}
+	//Passes the encoding of v to put(const unsigned char*, size_t) in pieces
+	template<typename Sink>
+	static inline void encodeBinary(const BigIntView& v, BigIntFormat f, Sink&& put){
+		size_t n = v.normalizedSize();
+		const uint64_t* a = v.limbs();
+		unsigned char buf[256];
+		buf[0] = (unsigned char)(binaryVersion << 4 | (f == BigIntFormat::varint) << 1 | (v.signum < 0 && n > 0));
+		if(f == BigIntFormat::limbs){
+			put(buf, (size_t)(putVarint(buf + 1, n) - buf));
+#ifdef BIGINT_BIG_ENDIAN
+			for(size_t i = 0;i < n;i += 32){
+				size_t c = std::min<size_t>(32, n - i);
+				uint64_t* t = reinterpret_cast<uint64_t*>(buf);
+				mpn::copy(t, a + i, c);
+				littleEndianLimbs(t, c);
+				put(buf, 8 * c);
+			}
+#else
+			put(reinterpret_cast<const unsigned char*>(a), 8 * n);
+#endif
+			return;
+		}
+		size_t bits = mpn::bitLength(a, n), k = 1;
+		for(size_t pos = 0;;){
+			size_t limb = pos / 64;
+			unsigned sh = pos % 64;
+			uint64_t x = limb < n ? a[limb] >> sh : 0;
+			if(sh > 57 && limb + 1 < n)x |= a[limb + 1] << (64 - sh);
+			pos += 7;
+			buf[k++] = (unsigned char)((x & 0x7f) | (pos < bits ? 0x80 : 0));
+			if(pos >= bits)break;
+			if(k == sizeof(buf)){
+				put(buf, k);
+				k = 0;
+			}
+		}
+		put(buf, k);
+	}
+	//Reads one value with get(unsigned char*, size_t), which returns false when the input ends early
+	template<typename Source>
+	static inline BigInt decodeBinary(Source&& get){
+		unsigned char head;
+		auto need = [&](unsigned char* p, size_t n){
+			if(n && !get(p, n))throw std::invalid_argument("BigInt: truncated binary input");
+		};
+		need(&head, 1);
+		if(head >> 4 != binaryVersion || (head & 0x0c))
+			throw std::invalid_argument("BigInt: unsupported binary header " + std::to_string(head));
+		BigInt ret;
+		if(!(head & 2)){
+			uint64_t n = 0;
+			for(unsigned sh = 0;;sh += 7){
+				unsigned char b;
+				need(&b, 1);
+				if(sh == 63 && b > 1)throw std::invalid_argument("BigInt: binary limb count overflows");
+				n |= (uint64_t)(b & 0x7f) << sh;
+				if(!(b & 0x80))break;
+			}
+			//Grows in chunks, so a corrupt count fails at the end of the input instead of allocating it up front
+			for(size_t done = 0;done < n;){
+				size_t c = (size_t)std::min<uint64_t>(n - done, (uint64_t)1 << 16);
+				ret.data.resize(done + c);
+				need(reinterpret_cast<unsigned char*>(ret.limbs() + done), 8 * c);
+				littleEndianLimbs(ret.limbs() + done, c);
+				done += c;
+			}
+		}
+		else{
+			for(size_t pos = 0;;pos += 7){
+				unsigned char b;
+				need(&b, 1);
+				size_t limb = pos / 64;
+				unsigned sh = pos % 64;
+				uint64_t x = b & 0x7f;
+				if(x){
+					if(ret.size() < limb + 2)ret.data.resize(limb + 2, 0);
+					ret.limbAt(limb) |= x << sh;
+					if(sh > 57)ret.limbAt(limb + 1) |= x >> (64 - sh);
+				}
+				if(!(b & 0x80))break;
+			}
+		}
+		ret.trim();
+		ret.signum = (head & 1) && !ret.isZero() ? -1 : 1;
+		return ret;
+	}
+	inline size_t binarySize(BigIntFormat f = BigIntFormat::limbs)const{
+		return binarySize(view(), f);
+	}
+	//Writes the binary encoding to [first, last) and returns the end, or nullptr if it does not fit
+	static inline unsigned char* toBinary(const BigIntView& v, unsigned char* first, unsigned char* last, BigIntFormat f = BigIntFormat::limbs){
+		if((size_t)(last - first) < binarySize(v, f))return nullptr;
+		encodeBinary(v, f, [&first](const unsigned char* p, size_t n){
+			std::memcpy(first, p, n);
+			first += n;
+		});
+		return first;
+	}
+	inline unsigned char* toBinary(unsigned char* first, unsigned char* last, BigIntFormat f = BigIntFormat::limbs)const{
+		return toBinary(view(), first, last, f);
+	}
+	inline std::vector<unsigned char> toBinary(BigIntFormat f = BigIntFormat::limbs)const{
+		std::vector<unsigned char> ret(binarySize(f));
+		toBinary(ret.data(), ret.data() + ret.size(), f);
+		return ret;
+	}
+	//Decodes the value at first and stores where it ends in *end, throws std::invalid_argument on malformed input
+	static inline BigInt fromBinary(const unsigned char* first, const unsigned char* last, const unsigned char** end = nullptr){
+		BigInt ret = decodeBinary([&first, last](unsigned char* p, size_t n){
+			if((size_t)(last - first) < n)return false;
+			std::memcpy(p, first, n);
+			first += n;
+			return true;
+		});
+		if(end)*end = first;
+		return ret;
+	}
+	//Stream errors are left in the stream state
+	inline void writeBinary(std::ostream& os, BigIntFormat f = BigIntFormat::limbs)const{
+		encodeBinary(view(), f, [&os](const unsigned char* p, size_t n){os.write(reinterpret_cast<const char*>(p), (std::streamsize)n);});
+	}
+	static inline BigInt readBinary(std::istream& is){
+		return decodeBinary([&is](unsigned char* p, size_t n){
+			return (bool)is.read(reinterpret_cast<char*>(p), (std::streamsize)n);
+		});
+	}
+#ifdef BIGINT_HAS_FD
+	//Unbuffered, reads never go past the value; failed system calls throw std::system_error
+	inline void writeBinary(int fd, BigIntFormat f = BigIntFormat::limbs)const{
+		encodeBinary(view(), f, [fd](const unsigned char* p, size_t n){
+			while(n){
+				ssize_t w = ::write(fd, p, n);
+				if(w < 0){
+					if(errno == EINTR)continue;
+					throw std::system_error(errno, std::generic_category(), "BigInt: write");
+				}
+				p += w;
+				n -= (size_t)w;
+			}
+		});
+	}
+	static inline BigInt readBinary(int fd){
+		return decodeBinary([fd](unsigned char* p, size_t n){
+			while(n){
+				ssize_t r = ::read(fd, p, n);
+				if(r < 0){
+					if(errno == EINTR)continue;
+					throw std::system_error(errno, std::generic_category(), "BigInt: read");
+				}
+				if(r == 0)return false;
+				p += r;
+				n -= (size_t)r;
+			}
+			return true;
+		});
+	}
+#endif
+};
+inline std::string BigIntView::toString()const{
+	std::string ret(BigInt::decimalDigitsBound(*this), '0');
+	char* end = BigInt::toChars(*this, &ret[0], &ret[0] + ret.size());
+	ret.resize(end - &ret[0]);
+	return ret;
+}
+/*
+ * Nodes of BigInt expressions. Operands are held by reference, so an expression has to be assigned to a
+ * BigInt before the end of the statement that builds it (auto x = a * b keeps dangling references).
+ */
+template<typename T>
+struct BigIntOperand{using type = T;};
+template<>
+struct BigIntOperand<BigInt>{using type = const BigInt&;};
+template<typename T>
+struct isBigIntOperand : std::integral_constant<bool, std::is_same<T, BigInt>::value || std::is_base_of<BigIntExpr<T>, T>::value>{};
+//The operations every node forwards to its operands, a plain BigInt is its own value
+inline size_t bigIntBound(const BigInt& x){return x.size();}
+template<typename E>
+inline size_t bigIntBound(const BigIntExpr<E>& e){return e.self().bound();}
+inline bool bigIntRefersTo(const BigInt& x, const BigInt& y){return &x == &y;}
+template<typename E>
+inline bool bigIntRefersTo(const BigIntExpr<E>& e, const BigInt& y){return e.self().refersTo(y);}
+inline const BigInt& bigIntValue(const BigInt& x){return x;}
+template<typename E>
+inline BigInt bigIntValue(const BigIntExpr<E>& e){return BigInt(e);}
+inline void bigIntEvalInto(const BigInt& x, BigInt& dst){
+	if(&x != &dst)dst = x;
+}
+template<typename E>
+inline void bigIntEvalInto(const BigIntExpr<E>& e, BigInt& dst){e.self().evalInto(dst);}
+inline void bigIntAddTo(const BigInt& x, BigInt& dst, int sign){
+	if(sign > 0)BigInt::add(dst, dst, x);
+	else BigInt::sub(dst, dst, x);
+}
+template<typename E>
+inline void bigIntAddTo(const BigIntExpr<E>& e, BigInt& dst, int sign){e.self().addTo(dst, sign);}
+//l * r
+template<typename L, typename R>
+struct BigIntProduct : BigIntExpr<BigIntProduct<L, R>>{
+	typename BigIntOperand<L>::type l;
+	typename BigIntOperand<R>::type r;
+	inline BigIntProduct(const L& lhs, const R& rhs) : l(lhs), r(rhs){}
+	inline size_t bound()const{return bigIntBound(l) + bigIntBound(r);}
+	inline bool refersTo(const BigInt& x)const{return bigIntRefersTo(l, x) || bigIntRefersTo(r, x);}
+	inline void evalInto(BigInt& dst)const{BigInt::mul(dst, bigIntValue(l), bigIntValue(r));}
+	//dst += sign * l * r with the product in scratch limbs
+	inline void addTo(BigInt& dst, int sign)const{
+		decltype(auto) a = bigIntValue(l);
+		decltype(auto) b = bigIntValue(r);
+		size_t an = std::max<size_t>(1, mpn::normalizedSize(a.limbs(), a.size()));
+		size_t bn = std::max<size_t>(1, mpn::normalizedSize(b.limbs(), b.size()));
+		mpn::TempLimbs t(an + bn);
+		BigInt::mulLimbs(t, a.limbs(), an, b.limbs(), bn);
+		dst.data.reserve(std::max(dst.size(), an + bn) + 1);
+		BigInt::addLimbs(dst, dst.limbs(), dst.size(), dst.signum, t, an + bn, sign * a.signum * b.signum);
+	}
+};
+//l + sign * r
+template<typename L, typename R>
+struct BigIntSum : BigIntExpr<BigIntSum<L, R>>{
+	typename BigIntOperand<L>::type l;
+	typename BigIntOperand<R>::type r;
+	int sign;
+	inline BigIntSum(const L& lhs, const R& rhs, int s) : l(lhs), r(rhs), sign(s){}
+	inline size_t bound()const{return std::max(bigIntBound(l), bigIntBound(r)) + 1;}
+	inline bool refersTo(const BigInt& x)const{return bigIntRefersTo(l, x) || bigIntRefersTo(r, x);}
+	inline void evalInto(BigInt& dst)const{
+		//Whichever side does not read dst goes in last
+		if(!bigIntRefersTo(r, dst)){
+			bigIntEvalInto(l, dst);
+			bigIntAddTo(r, dst, sign);
+		}
+		else if(!bigIntRefersTo(l, dst)){
+			bigIntEvalInto(r, dst);
+			if(sign < 0 && !dst.isZero())dst.signum = -dst.signum;
+			bigIntAddTo(l, dst, 1);
+		}
+		else{
+			BigInt t(*this);
+			dst.swap(t);
+		}
+	}
+	inline void addTo(BigInt& dst, int s)const{
+		if(refersTo(dst)){
+			BigInt t(*this);
+			bigIntAddTo(t, dst, s);
+			return;
+		}
+		bigIntAddTo(l, dst, s);
+		bigIntAddTo(r, dst, s * sign);
+	}
+};
+template<typename L, typename R, typename = typename std::enable_if<isBigIntOperand<L>::value && isBigIntOperand<R>::value>::type>
+inline BigIntProduct<L, R> operator*(const L& l, const R& r){return BigIntProduct<L, R>(l, r);}
+template<typename L, typename R, typename = typename std::enable_if<isBigIntOperand<L>::value && isBigIntOperand<R>::value>::type>
+inline BigIntSum<L, R> operator+(const L& l, const R& r){return BigIntSum<L, R>(l, r, 1);}
+template<typename L, typename R, typename = typename std::enable_if<isBigIntOperand<L>::value && isBigIntOperand<R>::value>::type>
+inline BigIntSum<L, R> operator-(const L& l, const R& r){return BigIntSum<L, R>(l, r, -1);}
+/*
+ * Precomputed constants for Montgomery arithmetic modulo a fixed odd modulus.
+ * Build one per modulus and reuse it, values in Montgomery form are residues with exactly size() limbs.
+ */
+struct MontgomeryContext{
+	using uint64_t = std::uint64_t;
+	using size_t = std::size_t;
+	BigInt modulus;
+	size_t n;
+	//-1/m mod 2^64
+	uint64_t minv;
+	//R^2 mod m and R mod m for R = 2^(64n)
+	BigInt r2;
+	BigInt one;
+	inline explicit MontgomeryContext(const BigInt& m) : modulus(m){
+		modulus.trim();
+		modulus.signum = 1;
+		assert(!modulus.isZero() && !modulus.even());
+		n = modulus.size();
+		minv = 0 - mpn::binvert(modulus.limbAt(0));
+		one = BigInt(n + 1, 0);
+		one.limbAt(n) = 1;
+		one.moda(modulus);
+		pad(one);
+		r2 = one.square();
+		r2.moda(modulus);
+		pad(r2);
+	}
+	//Takes the constants computed at compile time instead of dividing
+	template<std::size_t Bits>
+	inline explicit MontgomeryContext(const ModulusConstants<Bits>& c)
+	    : modulus(c.modulus.view()), n(c.n), minv(c.minv), r2(c.r2.view()), one(c.one.view()){
+		pad(r2);
+		pad(one);
+	}
+	inline size_t size()const{return n;}
+	inline void pad(BigInt& a)const{
+		a.trim();
+		a.data.resize(n, 0);
+	}
+	inline BigInt toMontgomery(const BigInt& a)const{
+		BigInt t = a;
+		t.signum = 1;
+		if(t.compareMagnitude(modulus) >= 0)t.moda(modulus);
+		pad(t);
+		return mul(t, r2);
+	}
+	/*
+	 * The n limbs of a residue. One stored in fewer limbs, e.g. after trim, adda or fromBinary, is zero
+	 * padded into spare, which holds n limbs.
+	 */
+	inline const uint64_t* residue(const BigInt& a, uint64_t* spare)const{
+		assert(mpn::normalizedSize(a.limbs(), a.size()) <= n);
+		if(a.size() >= n)return a.limbs();
+		mpn::copy(spare, a.limbs(), a.size());
+		mpn::zero(spare + a.size(), n - a.size());
+		return spare;
+	}
+	inline BigInt fromMontgomery(const BigInt& a)const{
+		mpn::TempLimbs t(2 * n + 1);
+		size_t an = std::min(n, a.size());
+		assert(mpn::normalizedSize(a.limbs(), a.size()) <= n);
+		mpn::copy(t, a.limbs(), an);
+		mpn::zero(t + an, 2 * n + 1 - an);
+		BigInt ret(n, 0);
+		mpn::redc(ret.limbs(), t, modulus.limbs(), n, minv);
+		return ret.trim();
+	}
+	//a b / R mod m for residues in Montgomery form
+	inline BigInt mul(const BigInt& a, const BigInt& b)const{
+		BigInt ret(n, 0);
+		mpn::TempLimbs t(mpn::mont_scratch(n) + 2 * n);
+		uint64_t* spare = t + mpn::mont_scratch(n);
+		mpn::mont_mul(ret.limbs(), residue(a, spare), residue(b, spare + n), modulus.limbs(), n, minv, t);
+		return ret;
+	}
+	inline BigInt square(const BigInt& a)const{
+		BigInt ret(n, 0);
+		mpn::TempLimbs t(mpn::mont_scratch(n) + n);
+		mpn::mont_sqr(ret.limbs(), residue(a, t + mpn::mont_scratch(n)), modulus.limbs(), n, minv, t);
+		return ret;
+	}
+	//r = a b / R mod m on raw n-limb residues, t holds mpn::mont_scratch(n) limbs
+	inline void mulInto(uint64_t* r, const uint64_t* a, const uint64_t* b, uint64_t* t)const{
+		mpn::mont_mul(r, a, b, modulus.limbs(), n, minv, t);
+	}
+	//Window width for an exponent of the given bit length, balancing table setup against saved multiplications
+	static inline unsigned windowSize(size_t bits){
+		static const size_t limits[] = {7, 25, 81, 241, 673, 1793, 4609};
+		unsigned w = 1;
+		for(size_t l : limits){
+			if(bits <= l)break;
+			++w;
+		}
+		return w;
+	}
+	//base^exp mod m with a sliding window over the exponent bits, both taken and returned in normal form
+	inline BigInt pow(const BigInt& base, const BigInt& exp)const{
+		size_t bits = exp.bitLength();
+		if(bits == 0)return fromMontgomery(one);
+		unsigned w = windowSize(bits);
+		size_t count = (size_t)1 << (w - 1);
+		const uint64_t* m = modulus.limbs();
+		mpn::TempLimbs t(mpn::mont_scratch(n));
+		//table[i] = x^(2i + 1)
+		mpn::TempLimbs table(count * n);
+		BigInt x = toMontgomery(base);
+		mpn::copy(table, x.limbs(), n);
+		if(count > 1){
+			mpn::mont_sqr(x.limbs(), x.limbs(), m, n, minv, t);
+			for(size_t i = 1;i < count;i++)
+				mpn::mont_mul(table + i * n, table + (i - 1) * n, x.limbs(), m, n, minv, t);
+		}
+		BigInt acc(n, 0);
+		bool started = false;
+		size_t i = bits;
+		while(i > 0){
+			if(!exp.testBit(i - 1)){
+				mpn::mont_sqr(acc.limbs(), acc.limbs(), m, n, minv, t);
+				--i;
+				continue;
+			}
+			//Longest window of at most w bits that starts at bit i - 1 and ends in a set bit
+			size_t j = i > w ? i - w : 0;
+			while(!exp.testBit(j))++j;
+			uint64_t digit = exp.extractBits(j, (unsigned)(i - j));
+			const uint64_t* entry = table + (digit >> 1) * n;
+			if(started){
+				for(size_t s = j;s < i;s++)mpn::mont_sqr(acc.limbs(), acc.limbs(), m, n, minv, t);
+				mpn::mont_mul(acc.limbs(), acc.limbs(), entry, m, n, minv, t);
+			}
+			else{
+				mpn::copy(acc.limbs(), entry, n);
+				started = true;
+			}
+			i = j;
+		}
+		return fromMontgomery(acc);
+	}
+	//base^exp mod m with fixed w-bit digits, every digit costs the same w squarings and one multiplication
+	inline BigInt powFixedWindow(const BigInt& base, const BigInt& exp)const{
+		size_t bits = exp.bitLength();
+		if(bits == 0)return fromMontgomery(one);
+		unsigned w = windowSize(bits);
+		size_t count = (size_t)1 << w;
+		const uint64_t* m = modulus.limbs();
+		mpn::TempLimbs t(mpn::mont_scratch(n));
+		//table[i] = x^i
+		mpn::TempLimbs table(count * n);
+		BigInt x = toMontgomery(base);
+		mpn::copy(table, one.limbs(), n);
+		mpn::copy(table + n, x.limbs(), n);
+		for(size_t i = 2;i < count;i++)
+			mpn::mont_mul(table + i * n, table + (i - 1) * n, x.limbs(), m, n, minv, t);
+		size_t digits = (bits + w - 1) / w;
+		BigInt acc(n, 0);
+		mpn::copy(acc.limbs(), table + exp.extractBits((digits - 1) * w, w) * n, n);
+		for(size_t d = digits - 1;d-- > 0;){
+			for(unsigned s = 0;s < w;s++)mpn::mont_sqr(acc.limbs(), acc.limbs(), m, n, minv, t);
+			uint64_t digit = exp.extractBits(d * w, w);
+			if(digit)mpn::mont_mul(acc.limbs(), acc.limbs(), table + digit * n, m, n, minv, t);
+		}
+		return fromMontgomery(acc);
+	}
+	/*
+	 * out[i] = bases[i]^exps[i] mod m for i < count, expCount is either count or 1 for one exponent shared
+	 * by all bases. The batch is spread over the thread pool; with AVX-512 IFMA every thread runs eight
+	 * exponentiations at once in the lanes of powLanes.
+	 */
+	inline void powBatch(BigInt* out, const BigInt* bases, size_t count, const BigInt* exps, size_t expCount)const{
+		assert(expCount == count || expCount == 1);
+		auto exponent = [&](size_t i) -> const BigInt&{return exps[expCount == 1 ? 0 : i];};
+		ThreadPool* pool = count > 1 ? mpn::parallelPool() : nullptr;
+#ifdef BIGINT_SIMD_X86
+		if(count >= batchMinLanes && mpn::simdLevel >= mpn::SimdLevel::avx512ifma && laneDigits() <= batchMaxDigits){
+			Lanes c = lanes();
+			parallelFor(pool, (count + 7) / 8, [&](size_t b, size_t e){
+				for(size_t g = b;g < e;g++){
+					const BigInt* e8[8];
+					size_t l = std::min<size_t>(8, count - 8 * g);
+					for(size_t i = 0;i < l;i++)e8[i] = &exponent(8 * g + i);
+					if(l >= batchMinLanes)powLanes(out + 8 * g, bases + 8 * g, e8, l, c);
+					else for(size_t i = 0;i < l;i++)out[8 * g + i] = pow(bases[8 * g + i], *e8[i]);
+				}
+			});
+			return;
+		}
+#endif
+		parallelFor(pool, count, [&](size_t b, size_t e){
+			for(size_t i = b;i < e;i++)out[i] = pow(bases[i], exponent(i));
+		});
+	}
+	inline std::vector<BigInt> powBatch(const std::vector<BigInt>& bases, const std::vector<BigInt>& exps)const{
+		std::vector<BigInt> ret(bases.size());
+		powBatch(ret.data(), bases.data(), bases.size(), exps.data(), exps.size());
+		return ret;
+	}
+#ifdef BIGINT_SIMD_X86
+	//Smallest batch worth running in lanes and the largest modulus (in 52 bit digits) powLanes takes
+	static inline size_t batchMinLanes = 2;
+	static constexpr size_t batchMaxDigits = 256;
+	//4m < 2^(52k) keeps the lane products below 2m
+	inline size_t laneDigits()const{return (modulus.bitLength() + 2 + 51) / 52;}
+	//Modulus constants for eight residues side by side in radix 2^52, digit d of lane l at index 8d + l
+	struct Lanes{
+		size_t k;
+		uint64_t minv;
+		LimbVector m;
+		//2^(104k) mod m, which brings a residue into Montgomery form
+		LimbVector r2;
+	};
+	inline Lanes lanes()const{
+		Lanes c;
+		c.k = laneDigits();
+		c.minv = minv & mpn::simd::mask52;
+		c.m.resize(8 * c.k, 0);
+		c.r2.resize(8 * c.k, 0);
+		BigInt r(104 * c.k / 64 + 1, 0);
+		r.limbAt(104 * c.k / 64) = (uint64_t)1 << (104 * c.k % 64);
+		r.moda(modulus);
+		for(size_t l = 0;l < 8;l++){
+			toLane(c.m.data(), c.k, l, modulus);
+			toLane(c.r2.data(), c.k, l, r);
+		}
+		return c;
+	}
+	//Writes the radix 2^52 digits of a < 2^(52k) into lane l
+	static inline void toLane(uint64_t* v, size_t k, size_t l, const BigInt& a){
+		size_t words = (52 * k + 63) / 64;
+		mpn::TempLimbs tmp(words + k);
+		uint64_t* w = tmp;
+		uint64_t* d = w + words;
+		size_t an = std::min(a.size(), words);
+		mpn::copy(w, a.limbs(), an);
+		mpn::zero(w + an, words - an);
+		mpn::simd::toRadix52(d, w, words, k);
+		for(size_t i = 0;i < k;i++)v[8 * i + l] = d[i];
+	}
+	//The n limb value in lane l
+	static inline BigInt fromLane(const uint64_t* v, size_t k, size_t l, size_t n){
+		mpn::TempLimbs d(k + 2);
+		for(size_t i = 0;i < k;i++)d[i] = v[8 * i + l];
+		d[k] = d[k + 1] = 0;
+		BigInt ret(n, 0);
+		mpn::simd::fromRadix52(ret.limbs(), n, d);
+		return ret;
+	}
+	//Up to eight exponentiations with a fixed window, every lane squares and multiplies in step with the others
+	inline void powLanes(BigInt* out, const BigInt* bases, const BigInt* const* exps, size_t count, const Lanes& c)const{
+		size_t k = c.k, v = 8 * k;
+		size_t bits = 0;
+		for(size_t i = 0;i < count;i++)bits = std::max(bits, exps[i]->bitLength());
+		//Window minimizing bits / w multiplications plus the 2^w table entries
+		unsigned w = 1;
+		while(w < 6 && bits / (w + 1) + ((size_t)2 << w) < bits / w + ((size_t)1 << w))++w;
+		size_t entries = (size_t)1 << w;
+		mpn::TempLimbs tmp((entries + 3) * v);
+		uint64_t* table = tmp;
+		uint64_t* acc = table + entries * v;
+		uint64_t* g = acc + v;
+		uint64_t* t = g + v;
+		const uint64_t* m = c.m.data();
+		mpn::zero(acc, v);
+		for(size_t i = 0;i < count;i++){
+			BigInt x = bases[i];
+			x.signum = 1;
+			if(x.compareMagnitude(modulus) >= 0)x.moda(modulus);
+			toLane(acc, k, i, x);
+		}
+		//table[e] = x^e in Montgomery form, starting from R mod m = r2 / R
+		mpn::zero(g, v);
+		for(size_t l = 0;l < 8;l++)g[l] = 1;
+		mpn::simd::mont_mul_ifma_x8(table, c.r2.data(), g, m, c.minv, k, t);
+		mpn::simd::mont_mul_ifma_x8(table + v, acc, c.r2.data(), m, c.minv, k, t);
+		for(size_t e = 2;e < entries;e++)
+			mpn::simd::mont_mul_ifma_x8(table + e * v, table + (e - 1) * v, table + v, m, c.minv, k, t);
+		size_t digits = (bits + w - 1) / w;
+		uint64_t e8[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		mpn::copy(acc, table, v);
+		for(size_t d = digits;d-- > 0;){
+			for(size_t i = 0;i < count;i++)e8[i] = exps[i]->extractBits(d * w, w);
+			if(d + 1 == digits){
+				mpn::simd::select_x8(acc, table, e8, k);
+				continue;
+			}
+			for(unsigned s = 0;s < w;s++)mpn::simd::mont_mul_ifma_x8(acc, acc, acc, m, c.minv, k, t);
+			mpn::simd::select_x8(g, table, e8, k);
+			mpn::simd::mont_mul_ifma_x8(acc, acc, g, m, c.minv, k, t);
+		}
+		//Multiplying by 1 leaves Montgomery form with a result of at most m
+		mpn::zero(g, v);
+		for(size_t l = 0;l < 8;l++)g[l] = 1;
+		mpn::simd::mont_mul_ifma_x8(acc, acc, g, m, c.minv, k, t);
+		for(size_t i = 0;i < count;i++){
+			out[i] = fromLane(acc, k, i, n);
+			if(out[i].compareMagnitude(modulus) >= 0)out[i].suba(modulus);
+			out[i].trim();
+		}
+	}
+#endif
+};
+/*
+ * Repeated reduction by a fixed modulus outside exponentiation, e.g. of the products of an accumulator loop.
+ * The reciprocal is computed once and values stay in normal form, so unlike MontgomeryContext nothing is
+ * converted in or out. A single limb modulus uses the two-by-one limb reciprocal of mpn::LimbDivisor instead.
+ */
+struct BarrettContext{
+	using uint64_t = std::uint64_t;
+	using size_t = std::size_t;
+	BigInt modulus;
+	size_t n;
+	//floor(2^(128n) / m), unused for a single limb modulus
+	BigInt mu;
+	mpn::LimbDivisor divisor;
+	inline explicit BarrettContext(const BigInt& m) : modulus(m){
+		modulus.trim();
+		modulus.signum = 1;
+		assert(!modulus.isZero());
+		n = modulus.size();
+		if(n == 1){
+			divisor = mpn::LimbDivisor(modulus.limbAt(0));
+			return;
+		}
+		BigInt r(2 * n + 1, 0);
+		r.limbAt(2 * n) = 1;
+		mu = r.divmod(modulus).first;
+	}
+	//Takes mu from the constants computed at compile time instead of dividing
+	template<std::size_t Bits>
+	inline explicit BarrettContext(const ModulusConstants<Bits>& c) : modulus(c.modulus.view()), n(c.n), mu(c.mu.view()){
+		mu.trim();
+		if(n == 1)divisor = mpn::LimbDivisor(modulus.limbAt(0));
+	}
+	inline size_t size()const{return n;}
+	//Scratch limbs needed by reduceInto
+	inline size_t scratch()const{return n == 1 ? 0 : mpn::barrett_scratch(n);}
+	//r = x mod m on raw limbs, r has n limbs and may alias x, t holds scratch() limbs
+	inline void reduceInto(uint64_t* r, const uint64_t* x, size_t xn, uint64_t* t)const{
+		if(n == 1)r[0] = xn ? mpn::mod_1(x, xn, divisor) : 0;
+		else mpn::barrett_reduce(r, x, xn, modulus.limbs(), n, mu.limbs(), mu.size(), t);
+	}
+	//a = |a| mod m keeping the sign of a, like moda
+	inline BigInt& reduce(BigInt& a)const{
+		size_t an = mpn::normalizedSize(a.limbs(), a.size());
+		if(an < n)return a;
+		mpn::TempLimbs t(scratch());
+		reduceInto(a.limbs(), a.limbs(), an, t);
+		a.data.resize(n);
+		a.trim();
+		if(a.isZero())a.signum = 1;
+		return a;
+	}
+	//|a| mod m
+	inline BigInt mod(const BigIntView& a)const{
+		BigInt ret(n, 0);
+		mpn::TempLimbs t(scratch());
+		reduceInto(ret.limbs(), a.limbs(), a.size(), t);
+		return ret.trim();
+	}
+	//dst = |a b| mod m, dst may be a or b
+	inline BigInt& mulMod(BigInt& dst, const BigIntView& a, const BigIntView& b)const{
+		size_t an = std::max<size_t>(1, a.normalizedSize());
+		size_t bn = std::max<size_t>(1, b.normalizedSize());
+		mpn::TempLimbs p(an + bn);
+		mpn::TempLimbs t(scratch());
+		BigInt::mulLimbs(p, a.limbs(), an, b.limbs(), bn);
+		dst.data.resize(n);
+		dst.signum = 1;
+		reduceInto(dst.limbs(), p, an + bn, t);
+		return dst.trim();
+	}
+	inline BigInt mulMod(const BigIntView& a, const BigIntView& b)const{
+		BigInt ret;
+		return mulMod(ret, a, b);
+	}
+};
+/*
+ * Lim-Lee comb for a base that is raised to many exponents modulo the same modulus.
+ * The exponent is read as `teeth` rows of `spacing` bits; entry i of the table is the product of
+ * base^(2^(j * spacing)) over the set bits j of i, so every column costs one squaring and at most one multiplication.
+ */
+struct FixedBaseComb{
+	using uint64_t = std::uint64_t;
+	using size_t = std::size_t;
+	MontgomeryContext ctx;
+	BigInt base;
+	size_t bits;
+	unsigned teeth;
+	size_t spacing;
+	LimbVector table;
+	inline FixedBaseComb(const MontgomeryContext& context, const BigInt& b, size_t maxExponentBits, unsigned combTeeth = 0)
+	    : ctx(context), base(b), bits(std::max<size_t>(1, maxExponentBits)){
+		teeth = combTeeth ? combTeeth : bits <= 64 ? 2 : bits <= 512 ? 4 : bits <= 2048 ? 6 : 8;
+		spacing = (bits + teeth - 1) / teeth;
+		size_t n = ctx.size();
+		const uint64_t* m = ctx.modulus.limbs();
+		mpn::TempLimbs t(mpn::mont_scratch(n));
+		table.resize(((size_t)1 << teeth) * n, 0);
+		uint64_t* tab = table.data();
+		mpn::copy(tab, ctx.one.limbs(), n);
+		BigInt g = ctx.toMontgomery(base);
+		for(unsigned j = 0;j < teeth;j++){
+			//g = base^(2^(j * spacing))
+			size_t row = (size_t)1 << j;
+			for(size_t i = 0;i < row;i++)
+				ctx.mulInto(tab + (row + i) * n, tab + i * n, g.limbs(), t);
+			for(size_t s = 0;s < spacing && j + 1 < teeth;s++)
+				mpn::mont_sqr(g.limbs(), g.limbs(), m, n, ctx.minv, t);
+		}
+	}
+	//base^exp mod m, exponents longer than the comb fall back to the sliding window
+	inline BigInt pow(const BigInt& exp)const{
+		if(exp.bitLength() > bits)return ctx.pow(base, exp);
+		size_t n = ctx.size();
+		const uint64_t* m = ctx.modulus.limbs();
+		const uint64_t* tab = table.data();
+		mpn::TempLimbs t(mpn::mont_scratch(n));
+		BigInt acc = ctx.one;
+		for(size_t k = spacing;k-- > 0;){
+			mpn::mont_sqr(acc.limbs(), acc.limbs(), m, n, ctx.minv, t);
+			size_t index = 0;
+			for(unsigned j = 0;j < teeth;j++)
+				index |= (size_t)exp.testBit(j * spacing + k) << j;
+			if(index)mpn::mont_mul(acc.limbs(), acc.limbs(), tab + index * n, m, n, ctx.minv, t);
+		}
+		return ctx.fromMontgomery(acc);
+	}
+};
+inline BigInt BigInt::modPow(const BigInt& o, const BigInt& mod)const{
+	if(!mod.even())return MontgomeryContext(mod).pow(*this, o);
+	BigInt t = *this;
+	t.signum = 1;
+	t.moda(mod);
+	BigInt acc(1), next;
+	acc.moda(mod);
+	//acc and next trade buffers, so the loop runs without allocating BigInts
+	for(size_t i = o.bitLength();i-- > 0;){
+		sqr(next, acc);
+		next.moda(mod);
+		acc.swap(next);
+		if(o.testBit(i)){
+			mul(next, acc, t);
+			next.moda(mod);
+			acc.swap(next);
+		}
+	}
+	return acc;
+}
+inline BigInt BigInt::modPow(const BigInt& o, const MontgomeryContext& ctx)const{
+	return ctx.pow(*this, o);
+}
+inline std::vector<BigInt> BigInt::modPowBatch(const std::vector<BigInt>& bases, const std::vector<BigInt>& exps, const BigInt& mod){
+	if(!mod.even())return MontgomeryContext(mod).powBatch(bases, exps);
+	assert(exps.size() == bases.size() || exps.size() == 1);
+	std::vector<BigInt> ret(bases.size());
+	parallelFor(bases.size() > 1 ? mpn::parallelPool() : nullptr, bases.size(), [&](size_t b, size_t e){
+		for(size_t i = b;i < e;i++)ret[i] = bases[i].modPow(exps[exps.size() == 1 ? 0 : i], mod);
+	});
+	return ret;
+}
+/*
+ * Unsigned integer of a fixed number of bits (a multiple of 64) with its limbs in a std::array.
+ * Arithmetic wraps modulo 2^Bits like the built in unsigned types, so there is no trimming, growth or signum.
+ * Everything is constexpr; up to fixedUnrollLimbs limbs the loops are unrolled at compile time and above
+ * that they keep compile time bounds.
+ */
+inline constexpr std::size_t fixedUnrollLimbs = 8;
+template<std::size_t Bits>
+struct FixedInt{
+	static_assert(Bits > 0 && Bits % 64 == 0, "FixedInt needs a positive multiple of 64 bits");
+	using size_t = std::size_t;
+	using uint64_t = std::uint64_t;
+	static constexpr size_t limbCount = Bits / 64;
+	//Limbs, least significant first
+	std::array<uint64_t, limbCount> data;
+	constexpr FixedInt() : data{}{}
+	constexpr FixedInt(uint64_t v) : data{}{data[0] = v;}
+	//The low Bits bits of o, negative values wrap around like a conversion to an unsigned type
+	inline explicit FixedInt(const BigInt& o) : data{}{
+		mpn::copy(data.data(), o.limbs(), std::min(limbCount, o.size()));
+		if(o.signum < 0)negate();
+	}
+	//Zero extends or truncates a FixedInt of another width
+	template<size_t B>
+	constexpr explicit FixedInt(const FixedInt<B>& o) : data{}{
+		for(size_t i = 0;i < std::min(limbCount, FixedInt<B>::limbCount);i++)data[i] = o.data[i];
+	}
+	inline BigInt toBigInt()const{
+		BigInt ret = BigInt::fromLimbs(data.begin(), data.end());
+		return ret.trim();
+	}
+	//The limbs up to the highest nonzero one, at least one like a trimmed BigInt
+	constexpr size_t normalizedSize()const{
+		size_t n = limbCount;
+		while(n > 1 && data[n - 1] == 0)--n;
+		return n;
+	}
+	constexpr BigIntView view()const{return BigIntView(data.data(), normalizedSize());}
+	/*
+	 * Parses an unsigned decimal number, in constant expressions too. Throws std::invalid_argument on malformed
+	 * input and std::out_of_range when the value needs more than Bits bits, which fails the compilation of a constexpr.
+	 */
+	static constexpr FixedInt parse(std::string_view s){
+		if(s.empty())throw std::invalid_argument("FixedInt: no digits");
+		FixedInt ret;
+		for(size_t i = 0;i < s.size();i += 19){
+			size_t end = std::min(s.size(), i + 19);
+			uint64_t v = 0, scale = 1;
+			for(size_t j = i;j < end;j++){
+				if(s[j] < '0' || s[j] > '9')
+					throw std::invalid_argument("FixedInt: invalid character at position " + std::to_string(j) + " in \"" + std::string(s) + "\"");
+				v = v * 10 + (uint64_t)(s[j] - '0');
+				scale *= 10;
+			}
+			if(ret.mulAdd1(scale, v))throw std::out_of_range("FixedInt: \"" + std::string(s) + "\" does not fit in " + std::to_string(Bits) + " bits");
+		}
+		return ret;
+	}
+	constexpr uint64_t& operator[](size_t i){return data[i];}
+	constexpr const uint64_t& operator[](size_t i)const{return data[i];}
+	constexpr size_t size()const{return limbCount;}
+	constexpr uint64_t* limbs(){return data.data();}
+	constexpr const uint64_t* limbs()const{return data.data();}
+
+	//Calls f(i) for i in [0, N), as a fold over the indices when N is small enough to unroll
+	template<size_t N, typename F>
+	static constexpr void unroll(F&& f){
+		if constexpr(N <= fixedUnrollLimbs)unrollIndices(f, std::make_index_sequence<N>());
+		else for(size_t i = 0;i < N;i++)f(i);
+	}
+	template<typename F, size_t... I>
+	static constexpr void unrollIndices(F& f, std::index_sequence<I...>){(f(I), ...);}
+	//False during constant evaluation; at run time the widths that are not unrolled use the mpn kernels
+	static constexpr bool runtimeKernels(){
+#if defined(__GNUC__) || defined(__clang__)
+		return limbCount > fixedUnrollLimbs && !__builtin_is_constant_evaluated();
+#else
+		return false;
+#endif
+	}
+	//a + b + c, c is the carry in and out
+	static constexpr uint64_t addc(uint64_t a, uint64_t b, uint64_t& c){
+		uint64_t s = a + b;
+		uint64_t c1 = s < a;
+		s += c;
+		c = c1 | (s < c);
+		return s;
+	}
+	//a - b - c, c is the borrow in and out
+	static constexpr uint64_t subb(uint64_t a, uint64_t b, uint64_t& c){
+		uint64_t d = a - b;
+		uint64_t c1 = a < b;
+		uint64_t r = d - c;
+		c = c1 | (d < c);
+		return r;
+	}
+	//a * b + x + c, the high limb goes to c
+	static constexpr uint64_t mulAdd(uint64_t a, uint64_t b, uint64_t x, uint64_t& c){
+#ifdef _DEF_INT128
+		unsigned __int128 p = (unsigned __int128)a * b + x + c;
+		c = (uint64_t)(p >> 64);
+		return (uint64_t)p;
+#else
+		uint64_t al = a & 0xffffffff, ah = a >> 32, bl = b & 0xffffffff, bh = b >> 32;
+		uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+		uint64_t mid = (ll >> 32) + (lh & 0xffffffff) + (hl & 0xffffffff);
+		uint64_t lo = (ll & 0xffffffff) | (mid << 32);
+		uint64_t hi = hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+		uint64_t carry = 0;
+		lo = addc(lo, x, carry);
+		hi += carry;
+		carry = 0;
+		lo = addc(lo, c, carry);
+		c = hi + carry;
+		return lo;
+#endif
+	}
+
+	//this = this * b + c, returns the limb that did not fit
+	constexpr uint64_t mulAdd1(uint64_t b, uint64_t c){
+		unroll<limbCount>([&](size_t i){data[i] = mulAdd(data[i], b, 0, c);});
+		return c;
+	}
+	constexpr bool isZero()const{
+		uint64_t acc = 0;
+		unroll<limbCount>([&](size_t i){acc |= data[i];});
+		return acc == 0;
+	}
+	constexpr bool testBit(size_t i)const{
+		return i < Bits && ((data[i / 64] >> (i % 64)) & 1);
+	}
+	constexpr size_t bitLength()const{
+		for(size_t i = limbCount;i-- > 0;){
+			if(!data[i])continue;
+#if defined(__GNUC__) || defined(__clang__)
+			return i * 64 + 64 - __builtin_clzll(data[i]);
+#else
+			size_t n = i * 64;
+			for(uint64_t x = data[i];x;x >>= 1)n++;
+			return n;
+#endif
+		}
+		return 0;
+	}
+	constexpr bool operator==(const FixedInt& o)const{
+		uint64_t acc = 0;
+		unroll<limbCount>([&](size_t i){acc |= data[i] ^ o.data[i];});
+		return acc == 0;
+	}
+	constexpr bool operator!=(const FixedInt& o)const{return !(*this == o);}
+	//The borrow out of this - o, without branching on the limbs
+	constexpr bool operator<(const FixedInt& o)const{
+		uint64_t c = 0;
+		unroll<limbCount>([&](size_t i){subb(data[i], o.data[i], c);});
+		return c;
+	}
+	constexpr bool operator>(const FixedInt& o)const{return o < *this;}
+	constexpr bool operator<=(const FixedInt& o)const{return !(o < *this);}
+	constexpr bool operator>=(const FixedInt& o)const{return !(*this < o);}
+	constexpr int compare(const FixedInt& o)const{return (int)(o < *this) - (int)(*this < o);}
+
+	constexpr FixedInt& operator+=(const FixedInt& o){
+		uint64_t c = 0;
+		unroll<limbCount>([&](size_t i){data[i] = addc(data[i], o.data[i], c);});
+		return *this;
+	}
+	constexpr FixedInt& operator-=(const FixedInt& o){
+		uint64_t c = 0;
+		unroll<limbCount>([&](size_t i){data[i] = subb(data[i], o.data[i], c);});
+		return *this;
+	}
+	constexpr FixedInt& negate(){
+		uint64_t c = 0;
+		unroll<limbCount>([&](size_t i){data[i] = subb(0, data[i], c);});
+		return *this;
+	}
+	constexpr FixedInt operator-()const{return FixedInt(*this).negate();}
+	constexpr FixedInt operator~()const{
+		FixedInt ret;
+		unroll<limbCount>([&](size_t i){ret.data[i] = ~data[i];});
+		return ret;
+	}
+	constexpr FixedInt& operator&=(const FixedInt& o){
+		unroll<limbCount>([&](size_t i){data[i] &= o.data[i];});
+		return *this;
+	}
+	constexpr FixedInt& operator|=(const FixedInt& o){
+		unroll<limbCount>([&](size_t i){data[i] |= o.data[i];});
+		return *this;
+	}
+	constexpr FixedInt& operator^=(const FixedInt& o){
+		unroll<limbCount>([&](size_t i){data[i] ^= o.data[i];});
+		return *this;
+	}
+	//Shifts of Bits or more give zero
+	constexpr FixedInt operator<<(size_t s)const{
+		FixedInt ret;
+		if(s >= Bits)return ret;
+		size_t q = s / 64;
+		unsigned b = s % 64;
+		unroll<limbCount>([&](size_t i){
+			if(i < q)return;
+			ret.data[i] = data[i - q] << b;
+			if(b && i > q)ret.data[i] |= data[i - q - 1] >> (64 - b);
+		});
+		return ret;
+	}
+	constexpr FixedInt operator>>(size_t s)const{
+		FixedInt ret;
+		if(s >= Bits)return ret;
+		size_t q = s / 64;
+		unsigned b = s % 64;
+		unroll<limbCount>([&](size_t i){
+			if(i + q >= limbCount)return;
+			ret.data[i] = data[i + q] >> b;
+			if(b && i + q + 1 < limbCount)ret.data[i] |= data[i + q + 1] << (64 - b);
+		});
+		return ret;
+	}
+	constexpr FixedInt& operator<<=(size_t s){return *this = *this << s;}
+	constexpr FixedInt& operator>>=(size_t s){return *this = *this >> s;}
+
+	//The full product through mpn::mul beats the truncated schoolbook product above the unrolled widths
+	static inline void mulLowKernel(FixedInt& r, const FixedInt& a, const FixedInt& b){
+		mpn::TempLimbs t(2 * limbCount);
+		mpn::mul(t, a.limbs(), limbCount, b.limbs(), limbCount);
+		mpn::copy(r.limbs(), t, limbCount);
+	}
+	//The low Bits bits of a * b, the unrolled loops only form the products below limb limbCount
+	static constexpr FixedInt mulLow(const FixedInt& a, const FixedInt& b){
+		FixedInt r;
+		if(runtimeKernels()){
+			mulLowKernel(r, a, b);
+			return r;
+		}
+		unroll<limbCount>([&](size_t i){
+			uint64_t c = 0;
+			if constexpr(limbCount <= fixedUnrollLimbs)
+				unroll<limbCount>([&](size_t j){if(i + j < limbCount)r.data[i + j] = mulAdd(a.data[i], b.data[j], r.data[i + j], c);});
+			else
+				for(size_t j = 0;j < limbCount - i;j++)r.data[i + j] = mulAdd(a.data[i], b.data[j], r.data[i + j], c);
+		});
+		return r;
+	}
+	//The full 2 * Bits bit product
+	static constexpr FixedInt<2 * Bits> mulWide(const FixedInt& a, const FixedInt& b){
+		FixedInt<2 * Bits> r;
+		if(runtimeKernels()){
+			mpn::mul(r.limbs(), a.limbs(), limbCount, b.limbs(), limbCount);
+			return r;
+		}
+		unroll<limbCount>([&](size_t i){
+			uint64_t c = 0;
+			unroll<limbCount>([&](size_t j){r.data[i + j] = mulAdd(a.data[i], b.data[j], r.data[i + j], c);});
+			r.data[i + limbCount] = c;
+		});
+		return r;
+	}
+	constexpr FixedInt& operator*=(const FixedInt& o){return *this = mulLow(*this, o);}
+
+	friend constexpr FixedInt operator+(FixedInt a, const FixedInt& b){return a += b;}
+	friend constexpr FixedInt operator-(FixedInt a, const FixedInt& b){return a -= b;}
+	friend constexpr FixedInt operator*(const FixedInt& a, const FixedInt& b){return mulLow(a, b);}
+	friend constexpr FixedInt operator&(FixedInt a, const FixedInt& b){return a &= b;}
+	friend constexpr FixedInt operator|(FixedInt a, const FixedInt& b){return a |= b;}
+	friend constexpr FixedInt operator^(FixedInt a, const FixedInt& b){return a ^= b;}
+};
+//A decimal literal as a FixedInt wide enough for its digits, parsed at compile time: 340282366920938463463374607431768211507_fixed
+template<char... C>
+constexpr auto operator""_fixed(){
+	constexpr char digits[] = {C...};
+	constexpr std::size_t bits = (sizeof...(C) * 3322 / 1000 + 64) / 64 * 64;
+	constexpr FixedInt<bits> ret = FixedInt<bits>::parse(std::string_view(digits, sizeof...(C)));
+	return ret;
+}
+/*
+ * Reduction constants of an odd modulus m with n limbs and R = 2^(64n), computed at compile time when m is constexpr:
+ * minv = -1/m mod 2^64, one = R mod m and r2 = R^2 mod m for Montgomery, and mu = floor(R^2 / m) for Barrett.
+ * One schoolbook division of R^2 by m yields all but minv.
+ */
+template<std::size_t Bits>
+struct ModulusConstants{
+	using uint64_t = std::uint64_t;
+	using size_t = std::size_t;
+	using Wide = FixedInt<Bits + 64>;
+	FixedInt<Bits> modulus;
+	size_t n;
+	uint64_t minv;
+	FixedInt<Bits> one;
+	FixedInt<Bits> r2;
+	Wide mu;
+	constexpr explicit ModulusConstants(const FixedInt<Bits>& m) : modulus(m), n(m.normalizedSize()), minv(0), one(), r2(), mu(){
+		if(!(m[0] & 1) || m == FixedInt<Bits>(1))throw std::invalid_argument("ModulusConstants: the modulus must be odd and above 1");
+		//Newton's iteration doubles the correct low bits, m is its own inverse mod 8
+		uint64_t inv = m[0];
+		for(int i = 0;i < 5;i++)inv *= 2 - m[0] * inv;
+		minv = 0 - inv;
+		//Knuth's algorithm D on d = m << s with the top bit set, after step k r = (2^(64k) mod m) << s
+		unsigned s = (unsigned)(64 * n - m.bitLength());
+		Wide d = Wide(m) << s, r = Wide(1) << s;
+		for(size_t k = 1;k <= 2 * n;k++){
+			r <<= 64;
+			uint64_t q = r[n] >= d[n - 1] ? ~(uint64_t)0 : divWord(r[n], r[n - 1], d[n - 1]);
+			Wide t = d;
+			t.mulAdd1(q, 0);
+			//The estimate is at most two too large
+			while(t > r){
+				t -= d;
+				--q;
+			}
+			r -= t;
+			//Only the low n + 1 quotient limbs can be nonzero
+			if(q)mu[2 * n - k] = q;
+			if(k == n)one = FixedInt<Bits>(r >> s);
+		}
+		r2 = FixedInt<Bits>(r >> s);
+	}
+	//(hi 2^64 + lo) / d for hi < d
+	static constexpr uint64_t divWord(uint64_t hi, uint64_t lo, uint64_t d){
+#ifdef _DEF_INT128
+		return (uint64_t)((((unsigned __int128)hi << 64) | lo) / d);
+#else
+		uint64_t q = 0;
+		for(int i = 63;i >= 0;i--){
+			bool top = hi >> 63;
+			hi = (hi << 1) | (lo >> 63);
+			lo <<= 1;
+			if(top || hi >= d){
+				hi -= d;
+				q |= (uint64_t)1 << i;
+			}
+		}
+		return q;
+#endif
+	}
 };
 namespace std{
+	//Zero limbs above the value do not change the hash, so views of differently padded equal values agree
 	template<>
-	struct hash<BigInt>{
-		inline size_t operator()(const BigInt& o)const{
+	struct hash<BigIntView>{
+		inline size_t operator()(const BigIntView& o)const{
 			size_t ret = 0;
 			std::for_each(o.begin(), o.end(), [&ret](const uint64_t& ui){ret ^= ui;});
 			return ret;
 		}
 	};
+	template<>
+	struct hash<BigInt>{
+		inline size_t operator()(const BigInt& o)const{
+			return hash<BigIntView>()(o.view());
+		}
+	};
+}
+inline std::ostream& operator<<(std::ostream& os, const BigInt& a){
+	size_t width = a.decimalDigitsBound();
+	std::unique_ptr<char[]> buf(new char[width]);
+	char* end = a.toChars(buf.get(), buf.get() + width);
+	return os.write(buf.get(), end - buf.get());
+}
+template<std::size_t Bits>
+inline std::ostream& operator<<(std::ostream& os, const FixedInt<Bits>& a){
+	return os << a.toBigInt();
+}
+//secure_prime's limbs are a constant in read only data, parsed and reduced at compile time
+inline constexpr FixedInt<2048> secure_prime_limbs = FixedInt<2048>::parse("25517712857249265246309662191040714920292930135958602873503082695880945015180270627160886016284304866241119009429935511497986916016509065559298646199688497746399172174316028774533924795864096565081478741603241830675436336762053778667047857025632695617746551090247164369324008907433218665135569658200641651876344533506145721941113011977317356006176781796659698883765657005845351846184505291996942442336931455986790727248315517902731173678888064950798931396279140373592203530274617983159864665935475637811846793653407441533829095478201308785445059955697867933027578011378694502392722655274554801068451419037021634697683");
+inline constexpr BigIntView secure_prime_view = secure_prime_limbs.view();
+inline constexpr ModulusConstants<2048> secure_prime_constants(secure_prime_limbs);
+inline const BigInt secure_prime(secure_prime_view);
+//Montgomery context for secure_prime, copied from secure_prime_constants on first use
+inline const MontgomeryContext& secure_prime_montgomery(){
+	static const MontgomeryContext ctx(secure_prime_constants);
+	return ctx;
+}
+//Barrett context for secure_prime, with mu taken from secure_prime_constants
+inline const BarrettContext& secure_prime_barrett(){
+	static const BarrettContext ctx(secure_prime_constants);
+	return ctx;
 }
-const static BigInt secure_prime("25517712857249265246309662191040714920292930135958602873503082695880945015180270627160886016284304866241119009429935511497986916016509065559298646199688497746399172174316028774533924795864096565081478741603241830675436336762053778667047857025632695617746551090247164369324008907433218665135569658200641651876344533506145721941113011977317356006176781796659698883765657005845351846184505291996942442336931455986790727248315517902731173678888064950798931396279140373592203530274617983159864665935475637811846793653407441533829095478201308785445059955697867933027578011378694502392722655274554801068451419037021634697683");
 #endif //BIGINT64_HPP
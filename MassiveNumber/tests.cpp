@@ -0,0 +1,827 @@
+#include "massive_int.hpp"
+#ifdef BIGINT_HAS_FD
+#include <unistd.h>
+#endif
+
+#include <array>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Checks against known values and algebraic invariants. Every group is one ctest test, run it as
+// `tests <group>`, or run `tests` alone for all of them.
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            ++failures;                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #cond "\n"; \
+        }                                                                             \
+    } while (0)
+
+constexpr size_t never = ~size_t(0) / 4;
+const uint64_t primes[] = {1000000007ULL, 998244353ULL, 18446744073709551557ULL};
+
+BigInt randomBigInt(std::mt19937_64& rng, size_t limbs) {
+    BigInt ret(rng, limbs);
+    // Keep the top limb nonzero so that the operand has exactly the requested size
+    ret.limbAt(limbs - 1) |= 1;
+    return ret;
+}
+
+// A random number of exactly the given bit length
+BigInt randomBits(std::mt19937_64& rng, size_t bits) {
+    std::vector<uint64_t> limbs((bits + 63) / 64);
+    for (uint64_t& l : limbs) l = rng();
+    if (bits % 64) limbs.back() &= (1ULL << (bits % 64)) - 1;
+    if (bits) limbs.back() |= 1ULL << ((bits - 1) % 64);
+    return BigInt::fromLimbs(limbs.begin(), limbs.end());
+}
+
+// 2^(64n) - 1, whose square 2^(128n) - 2^(64n + 1) + 1 has a known hex expansion
+BigInt allOnes(size_t n) {
+    return BigInt(n, ~0ULL);
+}
+
+std::string allOnesSquaredHex(size_t n) {
+    return std::string(16 * n - 1, 'f') + "e" + std::string(16 * n - 1, '0') + "1";
+}
+
+// x mod p for a single limb p, computed limb by limb with 128-bit arithmetic
+uint64_t modLimb(const BigInt& x, uint64_t p) {
+    ::uint_128bit r = 0;
+    for (size_t i = x.size(); i-- > 0;)
+        r = ((r << 64) | x.limbAt(i)) % p;
+    return (uint64_t)r;
+}
+
+uint64_t mulModLimb(uint64_t a, uint64_t b, uint64_t p) {
+    return (uint64_t)((::uint_128bit)a * b % p);
+}
+
+uint64_t powModLimb(uint64_t b, uint64_t e, uint64_t p) {
+    uint64_t r = 1 % p;
+    for (b %= p; e; e >>= 1, b = mulModLimb(b, b, p))
+        if (e & 1) r = mulModLimb(r, b, p);
+    return r;
+}
+
+// x mod p counting the sign, in [0, p)
+uint64_t residue(const BigInt& x, uint64_t p) {
+    uint64_t r = modLimb(x, p);
+    return x.signum < 0 && r ? p - r : r;
+}
+
+// A signed value modulo each of the primes, the reference for signed identities
+struct Residues {
+    std::array<uint64_t, 3> r;
+    explicit Residues(const BigInt& x) {
+        for (size_t i = 0; i < 3; i++) r[i] = residue(x, primes[i]);
+    }
+    template <typename F>
+    static Residues combine(const Residues& x, const Residues& y, F f) {
+        Residues ret = x;
+        for (size_t i = 0; i < 3; i++) ret.r[i] = f(x.r[i], y.r[i], primes[i]);
+        return ret;
+    }
+    friend Residues operator+(const Residues& x, const Residues& y) {
+        return combine(x, y, [](uint64_t a, uint64_t b, uint64_t p) { return (uint64_t)(((::uint_128bit)a + b) % p); });
+    }
+    friend Residues operator-(const Residues& x, const Residues& y) {
+        return combine(x, y, [](uint64_t a, uint64_t b, uint64_t p) { return a >= b ? a - b : a + (p - b); });
+    }
+    friend Residues operator*(const Residues& x, const Residues& y) {
+        return combine(x, y, mulModLimb);
+    }
+    bool operator==(const Residues& o) const { return r == o.r; }
+};
+
+// n random limbs with a random sign, or now and then zero
+BigInt signedRandom(std::mt19937_64& rng, size_t n) {
+    BigInt ret = rng() % 8 ? randomBigInt(rng, n) : BigInt(0);
+    if (rng() % 2 && !ret.isZero()) ret.signum = -1;
+    return ret;
+}
+
+// Restores the tuning globals a test lowered
+struct Tuning {
+    mpn::MultThresholds mult = mpn::multThresholds;
+    mpn::MultThresholds sqr = mpn::sqrThresholds;
+    size_t div = mpn::divThreshold;
+    size_t parallel = mpn::parallelThreshold;
+    size_t outOfCore = mpn::outOfCoreLimbs;
+    ~Tuning() {
+        mpn::multThresholds = mult;
+        mpn::sqrThresholds = sqr;
+        mpn::divThreshold = div;
+        mpn::parallelThreshold = parallel;
+        mpn::outOfCoreLimbs = outOfCore;
+    }
+};
+
+// Threshold sets that route small operands to each multiplication tier
+struct Tier {
+    const char* name;
+    mpn::MultThresholds thresholds;
+    size_t outOfCore = 0;
+};
+
+const std::vector<Tier>& tiers() {
+    static const std::vector<Tier> t = {
+        {"basecase", {never, never, never, never}},
+        {"karatsuba", {4, never, never, never}},
+        {"toom3", {4, 12, never, never}},
+        {"toom4", {4, 12, 24, never}},
+        {"ntt", {4, 12, 24, 32}},
+        {"blocked", {4, 12, 24, never}, 64},
+    };
+    return t;
+}
+
+void testMult() {
+    std::mt19937_64 rng(1);
+    for (const Tier& tier : tiers()) {
+        Tuning restore;
+        mpn::multThresholds = tier.thresholds;
+        mpn::outOfCoreLimbs = tier.outOfCore;
+        for (size_t n : {1, 3, 17, 40, 97, 200}) {
+            BigInt x = allOnes(n);
+            CHECK(x.mult(BigInt(x)).hexString() == allOnesSquaredHex(n));
+        }
+        // Balanced and unbalanced shapes against the schoolbook product and residues mod primes
+        const size_t shapes[][2] = {{1, 1}, {5, 3}, {33, 33}, {64, 50}, {150, 149}, {300, 37}, {257, 256}, {500, 120}};
+        for (auto& s : shapes) {
+            BigInt a = randomBigInt(rng, s[0]), b = randomBigInt(rng, s[1]);
+            BigInt c = a.mult(b);
+            CHECK(c.compare(a.multOld(b)) == 0);
+            CHECK(c.compare(b.mult(a)) == 0);
+            for (uint64_t p : primes)
+                CHECK(modLimb(c, p) == mulModLimb(modLimb(a, p), modLimb(b, p), p));
+        }
+        if (!failures) continue;
+        std::cerr << "mult tier " << tier.name << " failed\n";
+        return;
+    }
+}
+
+void testSquare() {
+    std::mt19937_64 rng(2);
+    for (const Tier& tier : tiers()) {
+        Tuning restore;
+        mpn::sqrThresholds = tier.thresholds;
+        mpn::multThresholds = tier.thresholds;
+        mpn::outOfCoreLimbs = tier.outOfCore;
+        for (size_t n : {1, 2, 17, 40, 97, 200})
+            CHECK(allOnes(n).square().hexString() == allOnesSquaredHex(n));
+        for (size_t n : {1, 7, 33, 64, 131, 300}) {
+            BigInt a = randomBigInt(rng, n);
+            CHECK(a.square().compare(a.multOld(a)) == 0);
+            CHECK(a.mult(a).compare(a.square()) == 0);
+        }
+        if (failures) {
+            std::cerr << "square tier " << tier.name << " failed\n";
+            return;
+        }
+    }
+}
+
+void testModPow() {
+    std::mt19937_64 rng(4);
+    // Single limb moduli against 128-bit square and multiply
+    for (uint64_t p : {1000000007ULL, 998244353ULL, 18446744073709551557ULL, 1000000000000ULL}) {
+        for (int i = 0; i < 8; i++) {
+            uint64_t b = rng(), e = rng() >> (i * 8);
+            BigInt mod((unsigned long long)p);
+            CHECK(BigInt((unsigned long long)b).modPow(BigInt((unsigned long long)e), mod).compare(BigInt((unsigned long long)powModLimb(b, e, p))) == 0);
+        }
+    }
+    // Fermat's little theorem for the 2048-bit secure_prime, b^(p-1) = 1 and b^p = b
+    BigInt pm1 = secure_prime;
+    pm1.suba(BigInt(1));
+    const MontgomeryContext& ctx = secure_prime_montgomery();
+    for (int i = 0; i < 2; i++) {
+        BigInt b = randomBigInt(rng, 20);
+        CHECK(b.modPow(pm1, secure_prime).compare(BigInt(1)) == 0);
+        CHECK(ctx.powFixedWindow(b, secure_prime).compare(b) == 0);
+    }
+    // Multi-limb odd and even moduli against square and multiply on mult and moda, residues mod primes as well
+    for (size_t n : {2, 5, 16}) {
+        for (bool odd : {true, false}) {
+            BigInt mod = randomBigInt(rng, n);
+            mod.limbAt(0) = odd ? (mod.limbAt(0) | 1) : (mod.limbAt(0) & ~1ULL);
+            BigInt base = randomBigInt(rng, n + 1), exp = randomBigInt(rng, 2);
+            BigInt ref(1), sq = base;
+            sq.moda(mod);
+            for (size_t bit = 0; bit < exp.bitLength(); bit++) {
+                if (exp.testBit(bit)) ref = ref.mult(sq).moda(mod);
+                sq = sq.mult(sq).moda(mod);
+            }
+            CHECK(base.modPow(exp, mod).compare(ref) == 0);
+            if (odd) {
+                MontgomeryContext m(mod);
+                CHECK(m.pow(base, exp).compare(ref) == 0);
+                CHECK(m.powFixedWindow(base, exp).compare(ref) == 0);
+                CHECK(base.modPow(exp, m).compare(ref) == 0);
+            }
+        }
+    }
+    // Batches agree with one exponentiation at a time, with shared and with separate exponents
+    for (size_t n : {1, 4, 9}) {
+        BigInt mod = randomBigInt(rng, n);
+        mod.limbAt(0) |= 1;
+        MontgomeryContext m(mod);
+        std::vector<BigInt> bases, exps;
+        for (int i = 0; i < 11; i++) {
+            bases.push_back(randomBigInt(rng, n));
+            exps.push_back(randomBigInt(rng, 1 + i % 3));
+        }
+        std::vector<BigInt> each = m.powBatch(bases, exps), shared = m.powBatch(bases, {exps[0]});
+        std::vector<BigInt> viaBigInt = BigInt::modPowBatch(bases, exps, mod);
+        for (size_t i = 0; i < bases.size(); i++) {
+            BigInt one = bases[i].modPow(exps[i], mod);
+            CHECK(each[i].compare(one) == 0);
+            CHECK(viaBigInt[i].compare(one) == 0);
+            CHECK(shared[i].compare(bases[i].modPow(exps[0], mod)) == 0);
+        }
+    }
+    // Residues stored in fewer limbs than the modulus, after trim or adda, are zero padded
+    BigInt mod = randomBigInt(rng, 8);
+    mod.limbAt(0) |= 1;
+    MontgomeryContext m(mod);
+    BigInt seven = m.toMontgomery(BigInt(7)), five = randomBigInt(rng, 5);
+    seven.trim();
+    BigInt expect = BigInt(7).mult(five).moda(mod);
+    CHECK(m.fromMontgomery(m.mul(seven, m.toMontgomery(five))).compare(expect) == 0);
+    BigInt small(3);
+    small.adda(BigInt(4));
+    CHECK(m.fromMontgomery(m.square(small)).compare(m.fromMontgomery(m.mul(small, small))) == 0);
+    CHECK(m.fromMontgomery(m.mul(m.toMontgomery(BigInt(1)), BigInt(1))).compare(m.fromMontgomery(BigInt(1))) == 0);
+    // The fixed-base comb against modPow for exponents below, at and above maxExponentBits; the last ones take the
+    // sliding window
+    BigInt g = randomBigInt(rng, 6);
+    g.moda(mod);
+    for (size_t bits : {64, 200, 1000}) {
+        for (unsigned teeth : {0u, 3u}) {
+            FixedBaseComb comb(m, g, bits, teeth);
+            CHECK(comb.pow(BigInt(0)).compare(BigInt(1)) == 0);
+            for (size_t eb : {size_t(1), bits / 2, bits - 1, bits, bits + 1, 2 * bits}) {
+                BigInt e = randomBits(rng, eb);
+                CHECK(comb.pow(e).compare(g.modPow(e, mod)) == 0);
+            }
+        }
+    }
+}
+
+void testRadix() {
+    // Known values
+    BigInt twoTo64 = BigInt::fromLimbs({0, 1});
+    CHECK(twoTo64.toString() == "18446744073709551616");
+    CHECK(BigInt(std::string("18446744073709551616")).compare(twoTo64) == 0);
+    CHECK(BigInt(std::string_view("18446744073709551616")).compare(twoTo64) == 0);
+    CHECK(BigInt(0).toString() == "0");
+    CHECK(twoTo64.toString(16) == "10000000000000000");
+    CHECK(twoTo64.toString(2) == "1" + std::string(64, '0'));
+    CHECK(BigInt("zz", 36).compare(BigInt(1295)) == 0);
+    CHECK(BigInt(255).toString(8) == "377" && BigInt(255).toString(32) == "7v" && BigInt(0).toString(7) == "0");
+    BigInt deadBeef(3735928559ULL);
+    deadBeef.signum = -1;
+    CHECK(BigInt::fromHex("-DeadBeef").compare(deadBeef) == 0);
+    CHECK(BigInt(65537).toBase64() == "AQAB" && BigInt::fromBase64("AQAB").compare(BigInt(65537)) == 0);
+    CHECK(BigInt(255).toBase64(true) == "_w" && BigInt::fromBase64("/w==").compare(BigInt(255)) == 0);
+    // 10^k is a one followed by k zeros, both through the basecase and the divide-and-conquer split
+    BigInt power(1);
+    for (size_t k = 1; k <= 2000; k++) {
+        power = power.mult(BigInt(10));
+        if (k % 37 && k != 2000) continue;
+        std::string s = "1" + std::string(k, '0');
+        CHECK(power.toString() == s);
+        CHECK(BigInt(s).compare(power) == 0);
+    }
+    // Malformed input
+    auto throws = [](std::function<void()> f) {
+        try {
+            f();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws([] { BigInt(std::string_view("12a")); }));
+    CHECK(throws([] { BigInt(std::string_view("-")); }));
+    CHECK(throws([] { BigInt("12", 2); }));
+    CHECK(throws([] { BigInt("", 16); }));
+    CHECK(throws([] { BigInt(5).toString(37); }));
+    CHECK(throws([] { BigInt::fromBase64("A"); }));
+    // Decimal round trips of signed numbers of every size class
+    std::mt19937_64 rng(5);
+    for (size_t n : {1, 2, 9, 45, 130, 700}) {
+        BigInt a = randomBigInt(rng, n);
+        std::string s = a.toString();
+        CHECK(BigInt(s).compare(a) == 0);
+        CHECK(BigInt("-" + s).compare(a) == -1 || a.isZero());
+        CHECK(BigInt(std::string_view(s)).compare(a) == 0);
+    }
+    // Round trips in every base, for every size class
+    for (unsigned base = 2; base <= 36; base++) {
+        for (size_t n : {1, 2, 9, 45, 130}) {
+            BigInt a = randomBigInt(rng, n);
+            if (n % 2) a.signum = -1;
+            std::string s = a.toString(base);
+            CHECK(BigInt((a.signum < 0 ? "-" : "") + s, base).compare(a) == 0);
+            BigInt magnitude = a;
+            magnitude.signum = 1;
+            CHECK(BigInt(s, base).compare(magnitude) == 0);
+        }
+    }
+    for (size_t n : {1, 2, 3, 50, 301}) {
+        BigInt a = randomBigInt(rng, n);
+        CHECK(BigInt::fromBase64(a.toBase64()).compare(a) == 0);
+        CHECK(BigInt::fromBase64(a.toBase64(true)).compare(a) == 0);
+        CHECK(BigInt::fromHex(a.hexString()).compare(a) == 0);
+    }
+}
+
+void testDivmod() {
+    // Truncation toward zero, the remainder takes the sign of the dividend and zero is positive
+    auto qr = BigInt(-7).divmod(BigInt(2));
+    CHECK(qr.first.compare(BigInt(-3)) == 0 && qr.second.compare(BigInt(-1)) == 0);
+    qr = BigInt(7).divmod(BigInt(-2));
+    CHECK(qr.first.compare(BigInt(-3)) == 0 && qr.second.compare(BigInt(1)) == 0);
+    qr = BigInt(-4).divmod(BigInt(2));
+    CHECK(qr.second.isZero() && qr.second.signum == 1);
+    BigInt m(-4);
+    m.moda(BigInt(2));
+    CHECK(m.isZero() && m.signum == 1);
+    BigInt barrettZero(-4);
+    BarrettContext(BigInt(2)).reduce(barrettZero);
+    CHECK(barrettZero.isZero() && barrettZero.signum == 1);
+    CHECK(mpn::LimbDivisor().divisor() == 1);
+
+    std::mt19937_64 rng(3);
+    // Thresholds below the smallest recursive split are clamped
+    for (size_t threshold : {size_t(32), size_t(4), size_t(2)}) {
+        Tuning restore;
+        mpn::divThreshold = threshold;
+        const size_t shapes[][2] = {{1, 1}, {2, 2}, {9, 1}, {20, 7}, {64, 31}, {200, 100}, {300, 41}, {151, 150}};
+        for (auto& s : shapes) {
+            // a = d q + r with r < d known in advance
+            BigInt d = randomBigInt(rng, s[1]), q = randomBigInt(rng, s[0] - s[1] + 1), r = randomBigInt(rng, s[1]);
+            r.moda(d);
+            BigInt a = d.mult(q);
+            a.adda(r);
+            auto got = a.divmod(d);
+            CHECK(got.first.compare(q) == 0);
+            CHECK(got.second.compare(r) == 0);
+            BigInt t = a;
+            CHECK(t.moda(d).compare(r) == 0);
+            BarrettContext barrett(d);
+            CHECK(barrett.mod(a).compare(r) == 0);
+            BigInt reduced = a;
+            CHECK(barrett.reduce(reduced).compare(r) == 0);
+            // Signs follow truncated division
+            BigInt na = a;
+            na.signum = -1;
+            auto neg = na.divmod(d);
+            CHECK(neg.first.compareMagnitude(q) == 0 && (q.isZero() || neg.first.signum == -1));
+            CHECK(neg.second.compareMagnitude(r) == 0 && (r.isZero() ? neg.second.signum == 1 : neg.second.signum == -1));
+        }
+    }
+    // Division by a limb
+    const BigInt big = randomBigInt(rng, 40);
+    for (uint64_t d : {3ULL, 10ULL, 1000000007ULL, 1ULL << 63, ~0ULL}) {
+        auto small = big.divmodSmall(d);
+        CHECK(small.second == modLimb(big, d));
+        BigInt back = small.first.mult(BigInt((unsigned long long)d));
+        back.adda(BigInt((unsigned long long)small.second));
+        CHECK(back.compare(big) == 0);
+        CHECK(big.div(d).compare(small.first) == 0 && big.mod(d) == small.second);
+    }
+}
+
+void testParallel() {
+    std::mt19937_64 rng(7);
+    Tuning restore;
+    size_t threads = mpn::parallelThreads();
+    // Every parallel path against the same work done serially, which has to match bit for bit
+    struct Work {
+        std::vector<BigInt> results;
+        std::string decimal;
+    };
+    std::vector<BigInt> operands;
+    for (size_t n : {300, 130, 257, 256, 500, 700}) operands.push_back(randomBigInt(rng, n));
+    auto run = [&](const Tier& tier) {
+        mpn::multThresholds = tier.thresholds;
+        mpn::sqrThresholds = tier.thresholds;
+        mpn::outOfCoreLimbs = tier.outOfCore;
+        Work w;
+        for (size_t i = 0; i + 1 < operands.size(); i += 2) {
+            w.results.push_back(operands[i].mult(operands[i + 1]));
+            w.results.push_back(operands[i].square());
+        }
+        w.decimal = operands.back().mult(operands.back()).toString();
+        w.results.push_back(BigInt(std::string_view(w.decimal)));
+        return w;
+    };
+    for (const Tier& tier : tiers()) {
+        mpn::setParallelThreads(1);
+        Work serial = run(tier);
+        mpn::setParallelThreads(4);
+        mpn::parallelThreshold = 8;
+        Work parallel = run(tier);
+        mpn::parallelThreshold = restore.parallel;
+        CHECK(parallel.decimal == serial.decimal);
+        for (size_t i = 0; i < serial.results.size(); i++) {
+            CHECK(parallel.results[i].size() == serial.results[i].size());
+            CHECK(parallel.results[i].compare(serial.results[i]) == 0);
+        }
+        if (failures) {
+            std::cerr << "parallel tier " << tier.name << " failed\n";
+            break;
+        }
+    }
+    mpn::setParallelThreads(4);
+    ThreadPool* pool = mpn::parallelPool();
+    CHECK(pool && pool->size() == 3);
+    // parallelFor covers every index exactly once, also when tasks fork tasks of their own
+    std::vector<int> hits(1000);
+    parallelFor(pool, hits.size(), [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++) hits[i]++;
+    });
+    CHECK(std::count(hits.begin(), hits.end(), 1) == (std::ptrdiff_t)hits.size());
+    std::vector<int> nested(64 * 64);
+    parallelFor(pool, 64, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; i++)
+            parallelFor(pool, 64, [&](size_t b2, size_t e2) {
+                for (size_t j = b2; j < e2; j++) nested[i * 64 + j]++;
+            });
+    });
+    CHECK(std::count(nested.begin(), nested.end(), 1) == (std::ptrdiff_t)nested.size());
+    // An exception in a task reaches wait()
+    bool threw = false;
+    try {
+        TaskGroup tasks(pool);
+        tasks.run([] { throw std::runtime_error("task"); });
+        tasks.wait();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+    // Batches spread over the pool
+    BigInt mod = randomBigInt(rng, 5);
+    mod.limbAt(0) |= 1;
+    MontgomeryContext m(mod);
+    std::vector<BigInt> bases, exps;
+    for (int i = 0; i < 20; i++) {
+        bases.push_back(randomBigInt(rng, 5));
+        exps.push_back(randomBigInt(rng, 2));
+    }
+    std::vector<BigInt> batch = m.powBatch(bases, exps);
+    for (size_t i = 0; i < bases.size(); i++) CHECK(batch[i].compare(m.pow(bases[i], exps[i])) == 0);
+    mpn::setParallelThreads(threads);
+}
+
+void testExpressions() {
+    // mult works on magnitudes like adda, suba and moda, the operators and three operand functions are signed
+    CHECK(BigInt(-3).mult(BigInt(5)).compare(BigInt(15)) == 0);
+    BigInt product = BigInt(-3) * BigInt(5);
+    CHECK(product.compare(BigInt(-15)) == 0);
+    product = BigInt(-3) * BigInt(0);
+    CHECK(product.isZero() && product.signum == 1);
+
+    std::mt19937_64 rng(8);
+    auto valid = [](const BigInt& x) { return !x.isZero() || x.signum == 1; };
+    for (int round = 0; round < 60; round++) {
+        size_t n = 1 + round % 6 * 7;
+        const BigInt a = signedRandom(rng, n), b = signedRandom(rng, n / 2 + 1), c = signedRandom(rng, n + 2);
+        const Residues ra(a), rb(b), rc(c);
+        BigInt x = c;
+        x = a * b + x;
+        CHECK(Residues(x) == ra * rb + rc && valid(x));
+        BigInt y;
+        BigInt::mul(y, a, b);
+        BigInt::add(y, y, c);
+        CHECK(y.compare(x) == 0);
+        x = c;
+        x += a * b;
+        CHECK(x.compare(y) == 0);
+        x = c;
+        x = a * b - x;
+        CHECK(Residues(x) == ra * rb - rc && valid(x));
+        x = a;
+        x -= x * b;
+        CHECK(Residues(x) == ra - ra * rb && valid(x));
+        x = a;
+        x = (x + b) * (x - c);
+        CHECK(Residues(x) == (ra + rb) * (ra - rc) && valid(x));
+        x = a;
+        BigInt::sub(x, b, x);
+        CHECK(Residues(x) == rb - ra && valid(x));
+        x = a;
+        BigInt::add(x, x, x);
+        CHECK(Residues(x) == ra + ra && valid(x));
+        x = a;
+        x *= x;
+        CHECK(Residues(x) == ra * ra && x.signum == 1);
+        x = a;
+        BigInt::mul(x, b, x);
+        CHECK(Residues(x) == rb * ra && valid(x));
+        x = a;
+        x = x * x + x;
+        CHECK(Residues(x) == ra * ra + ra && valid(x));
+        x = b;
+        BigInt::sub(x, x, x);
+        CHECK(x.isZero() && x.signum == 1);
+        BigInt z = a * b + c * a - b;
+        CHECK(Residues(z) == ra * rb + rc * ra - rb && valid(z));
+        BigInt::sqr(z, c);
+        CHECK(Residues(z) == rc * rc && z.signum == 1);
+    }
+}
+
+void testFixed() {
+    using F128 = FixedInt<128>;
+    constexpr F128 max = ~F128();
+    // Compile time
+    static_assert((F128(1) << 127 >> 127) == F128(1), "shift round trip");
+    static_assert((F128(1) << 64)[1] == 1 && (F128(1) << 64)[0] == 0, "shift by a whole limb");
+    static_assert((F128(5) << 128).isZero() && (max >> 128).isZero() && (max << 300).isZero(), "shifts of Bits or more give zero");
+    static_assert((max >> 127) == F128(1) && (max << 127) == (F128(1) << 127), "shifts to the last bit");
+    static_assert(F128::mulLow(max, max) == F128(1), "(2^128 - 1)^2 = 1 mod 2^128");
+    static_assert(F128::mulWide(max, max)[0] == 1 && F128::mulWide(max, max)[1] == 0, "low half of (2^128 - 1)^2");
+    static_assert(F128::mulWide(max, max)[2] == ~1ULL && F128::mulWide(max, max)[3] == ~0ULL, "high half of (2^128 - 1)^2");
+    static_assert(max + F128(1) == F128() && F128() - F128(1) == max, "arithmetic wraps");
+    static_assert(F128::parse("340282366920938463463374607431768211455") == max, "2^128 - 1");
+    static_assert(F128::parse("18446744073709551616") == (F128(1) << 64), "2^64");
+    static_assert(std::is_same<decltype(9999999999999999999_fixed), FixedInt<64>>::value, "19 digits fit in one limb");
+    static_assert(std::is_same<decltype(18446744073709551616_fixed), FixedInt<128>>::value, "20 digits take two limbs");
+    static_assert(std::is_same<decltype(340282366920938463463374607431768211455_fixed), FixedInt<192>>::value, "a limb more when the digits do not rule out one");
+    static_assert(F128(340282366920938463463374607431768211455_fixed) == max, "_fixed parses like parse");
+    bool outOfRange = false, invalid = false;
+    try {
+        FixedInt<64>::parse("18446744073709551616");
+    } catch (const std::out_of_range&) {
+        outOfRange = true;
+    }
+    try {
+        FixedInt<64>::parse("12x");
+    } catch (const std::invalid_argument&) {
+        invalid = true;
+    }
+    CHECK(outOfRange && invalid);
+    // Run time, through the mpn kernels above fixedUnrollLimbs, against BigInt truncated to the width
+    static_assert(FixedInt<1024>::limbCount > fixedUnrollLimbs, "1024 bits are not unrolled");
+    std::mt19937_64 rng(9);
+    auto truncate = [](const BigInt& x, size_t limbs) {
+        BigInt ret = BigInt::fromLimbs(x.limbs(), x.limbs() + std::min(limbs, x.size()));
+        return ret.trim();
+    };
+    for (int i = 0; i < 20; i++) {
+        BigInt a = randomBigInt(rng, 1 + i % 16), b = randomBigInt(rng, 16 - i % 16);
+        FixedInt<1024> fa(a), fb(b);
+        CHECK(fa.toBigInt().compare(a) == 0);
+        CHECK((fa * fb).toBigInt().compare(truncate(a.mult(b), 16)) == 0);
+        CHECK(FixedInt<1024>::mulWide(fa, fb).toBigInt().compare(a.mult(b)) == 0);
+        BigInt sum = a;
+        sum.adda(b);
+        CHECK((fa + fb).toBigInt().compare(truncate(sum, 16)) == 0);
+        CHECK((fa + fb - fb) == fa);
+        CHECK((fa << 1000 >> 1000).toBigInt().compare(truncate(a, 1)) == 0 || a.limbAt(0) >> 24);
+        CHECK(((fa << 64) >> 64).toBigInt().compare(truncate(a, 15)) == 0);
+        CHECK(FixedInt<128>(fa) == FixedInt<128>(truncate(a, 2)));
+    }
+    // Negative values wrap like a conversion to an unsigned type
+    CHECK(F128(BigInt(-1)) == max);
+}
+
+void testConstants() {
+    // The constants computed at compile time equal what the contexts compute at run time
+    auto matches = [](const auto& c, const BigInt& m) {
+        MontgomeryContext mont(m);
+        bool same = c.n == mont.n && c.minv == mont.minv;
+        same = same && BigInt(c.one.view()).compare(mont.one) == 0 && BigInt(c.r2.view()).compare(mont.r2) == 0;
+        if (c.n > 1) {
+            BarrettContext barrett(m);
+            same = same && BigInt(c.mu.view()).compare(barrett.mu) == 0;
+        }
+        return same;
+    };
+    CHECK(matches(secure_prime_constants, secure_prime));
+    CHECK(secure_prime.compare(BigInt(secure_prime_constants.modulus.view())) == 0);
+    const MontgomeryContext& mont = secure_prime_montgomery();
+    CHECK(mont.minv == secure_prime_constants.minv && mont.r2.compare(BigInt(secure_prime_constants.r2.view())) == 0);
+    const BarrettContext& barrett = secure_prime_barrett();
+    CHECK(barrett.mu.compare(BigInt(secure_prime_constants.mu.view())) == 0);
+    // Small moduli of one and of two limbs, as constant expressions
+    constexpr ModulusConstants<64> single(FixedInt<64>(1000000007));
+    constexpr ModulusConstants<128> pair(FixedInt<128>::parse("340282366920938463463374607431768211297"));
+    static_assert(single.n == 1 && pair.n == 2, "limb counts");
+    static_assert(single.minv * 1000000007ULL == ~0ULL, "minv is -1/m mod 2^64");
+    CHECK(matches(single, BigInt(1000000007)));
+    CHECK(matches(pair, pair.modulus.toBigInt()));
+    bool threw = false;
+    try {
+        ModulusConstants<64> even(FixedInt<64>(10));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+void testViews() {
+    std::mt19937_64 rng(11);
+    BigInt a = randomBigInt(rng, 4), b = randomBigInt(rng, 2);
+    BigInt product = a.mult(b);
+    // Read only operations on views agree with the BigInt ones, padding zeros included
+    std::vector<uint64_t> padded(a.limbs(), a.limbs() + a.size());
+    padded.resize(9, 0);
+    BigIntView av(padded.data(), padded.size());
+    CHECK(av.compare(a) == 0 && BigInt(av).compare(a) == 0);
+    CHECK(BigInt(b).mult(av).compare(product) == 0);
+    BigInt sum = b;
+    CHECK(sum.adda(av).compare(BigInt(a).adda(b)) == 0);
+    BigInt rem = a;
+    CHECK(rem.moda(BigIntView(b.limbs(), b.size())).compare(BigInt(a).moda(b)) == 0);
+    CHECK(std::hash<BigIntView>()(av) == std::hash<BigInt>()(a));
+    // Results in a mutable view are zero padded up to its size
+    const uint64_t garbage = 0xa5a5a5a5a5a5a5a5ULL;
+    std::vector<uint64_t> buffer(12, garbage);
+    MutableBigIntView dst(buffer.data(), 10);
+    BigInt::mul(dst, a, b);
+    CHECK(BigInt(BigIntView(dst)).compare(product) == 0 && dst.signum == 1);
+    CHECK(buffer[8] == 0 && buffer[9] == 0 && buffer[10] == garbage);
+    BigInt negative = b;
+    negative.signum = -1;
+    BigInt::mul(dst, a, negative);
+    CHECK(dst.signum == -1 && BigInt(BigIntView(dst.limbs(), dst.size())).compare(product) == 0);
+    // Operands inside dst's limbs go through scratch space
+    std::fill(buffer.begin(), buffer.end(), garbage);
+    std::copy(a.limbs(), a.limbs() + 4, buffer.begin());
+    std::copy(b.limbs(), b.limbs() + 2, buffer.begin() + 4);
+    MutableBigIntView whole(buffer.data(), 10);
+    BigInt::mul(whole, BigIntView(buffer.data(), 4), BigIntView(buffer.data() + 4, 2));
+    CHECK(BigInt(BigIntView(whole)).compare(product) == 0);
+    CHECK(std::all_of(buffer.begin() + product.size(), buffer.begin() + 10, [](uint64_t l) { return l == 0; }));
+    CHECK(buffer[10] == garbage);
+    // A product that fits only once its top zero limbs are dropped, in place over its first operand
+    std::fill(buffer.begin(), buffer.end(), garbage);
+    std::copy(a.limbs(), a.limbs() + 4, buffer.begin());
+    buffer[4] = 0;
+    MutableBigIntView tight(buffer.data(), 6);
+    BigInt::mul(tight, BigIntView(buffer.data(), 5), BigIntView(b.limbs(), 2));
+    CHECK(BigInt(BigIntView(tight)).compare(product) == 0 && buffer[6] == garbage);
+    // add and sub with an operand at dst's first limb
+    std::fill(buffer.begin(), buffer.end(), garbage);
+    std::copy(a.limbs(), a.limbs() + 4, buffer.begin());
+    MutableBigIntView acc(buffer.data(), 6);
+    BigInt::add(acc, BigIntView(buffer.data(), 4), b);
+    CHECK(BigInt(BigIntView(acc)).compare(BigInt(a).adda(b)) == 0 && buffer[4] == 0 && buffer[5] == 0);
+    BigInt::sub(acc, BigIntView(buffer.data(), 6), a);
+    CHECK(BigInt(BigIntView(acc)).compare(b) == 0 && std::all_of(buffer.begin() + 2, buffer.begin() + 6, [](uint64_t l) { return l == 0; }));
+    BigInt::sub(acc, b, a);
+    CHECK(acc.signum == -1 && BigInt(BigIntView(acc.limbs(), acc.size())).compare(BigInt(a).suba(b)) == 0);
+    BigInt::sub(acc, b, b);
+    CHECK(acc.isZero() && acc.signum == 1);
+    // The three operand BigInt functions take views as well
+    BigInt out;
+    BigInt::mul(out, av, BigIntView(b.limbs(), b.size(), -1));
+    CHECK(out.signum == -1 && out.compareMagnitude(product) == 0);
+    BigInt::add(out, av, BigIntView(b.limbs(), b.size(), -1));
+    CHECK(out.compare(BigInt(a).suba(b)) == 0);
+}
+
+void testBinary() {
+    std::mt19937_64 rng(6);
+    // Header byte version << 4 | varint << 1 | negative, then the LEB128 limb count and the limbs
+    std::vector<unsigned char> one = BigInt(-1).toBinary();
+    CHECK(one == std::vector<unsigned char>({0x11, 0x01, 0x01, 0, 0, 0, 0, 0, 0, 0}));
+    CHECK(BigInt(300).toBinary(BigIntFormat::varint) == std::vector<unsigned char>({0x12, 0xac, 0x02}));
+    std::stringstream stream;
+    std::vector<BigInt> values = {BigInt(0), BigInt(-1), BigInt(300)};
+    for (size_t n : {1, 4, 5, 70, 3000}) values.push_back(randomBigInt(rng, n));
+    values.back().signum = -1;
+    for (const BigInt& v : values) {
+        for (BigIntFormat f : {BigIntFormat::limbs, BigIntFormat::varint}) {
+            std::vector<unsigned char> buf = v.toBinary(f);
+            CHECK(buf.size() == v.binarySize(f));
+            const unsigned char* end = nullptr;
+            CHECK(BigInt::fromBinary(buf.data(), buf.data() + buf.size(), &end).compare(v) == 0);
+            CHECK(end == buf.data() + buf.size());
+            v.writeBinary(stream, f);
+        }
+    }
+    for (const BigInt& v : values) {
+        CHECK(BigInt::readBinary(stream).compare(v) == 0);
+        CHECK(BigInt::readBinary(stream).compare(v) == 0);
+    }
+    auto truncated = [](std::function<void()> f) {
+        try {
+            f();
+        } catch (const std::invalid_argument&) {
+            return true;
+        }
+        return false;
+    };
+    std::vector<unsigned char> cut = values.back().toBinary();
+    cut.pop_back();
+    CHECK(truncated([&] { BigInt::fromBinary(cut.data(), cut.data() + cut.size()); }));
+#ifdef BIGINT_HAS_FD
+    // The same values through a pipe, which stays below its buffer size so nothing blocks
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    for (size_t i = 0; i + 1 < values.size(); i++) {
+        values[i].writeBinary(fds[1]);
+        values[i].writeBinary(fds[1], BigIntFormat::varint);
+    }
+    for (size_t i = 0; i + 1 < values.size(); i++) {
+        CHECK(BigInt::readBinary(fds[0]).compare(values[i]) == 0);
+        CHECK(BigInt::readBinary(fds[0]).compare(values[i]) == 0);
+    }
+    // A value cut short by the writer closing its end
+    std::vector<unsigned char> partial = values[5].toBinary();
+    CHECK(::write(fds[1], partial.data(), partial.size() - 3) == (ssize_t)(partial.size() - 3));
+    ::close(fds[1]);
+    CHECK(truncated([&] { BigInt::readBinary(fds[0]); }));
+    CHECK(truncated([&] { BigInt::readBinary(fds[0]); }));
+    ::close(fds[0]);
+#endif
+}
+
+void testMmap() {
+#ifdef BIGINT_HAS_MMAP
+    std::mt19937_64 rng(12);
+    BigInt a = randomBigInt(rng, 300), b = randomBigInt(rng, 170);
+    // In memory results first
+    BigInt product = a.mult(b), square = a.square(), power(1);
+    for (int i = 0; i < 40; i++) power = power.mult(b);
+    std::string decimal = product.toString();
+    auto qr = product.divmod(a);
+    {
+        Tuning restore;
+        MmapLimbAllocator disk("", 64);
+        setDefaultLimbAllocator(&disk);
+        setScratchLimbAllocator(&disk);
+        mpn::outOfCoreLimbs = 96;
+        {
+            BigInt x = a, y = b;
+            CHECK(disk.mappedBytes() > 0);
+            CHECK(x.mult(y).compare(product) == 0);
+            CHECK(x.square().compare(square) == 0);
+            BigInt p = x.mult(y);
+            CHECK(p.toString() == decimal);
+            CHECK(BigInt(std::string_view(decimal)).compare(product) == 0);
+            auto got = p.divmod(x);
+            CHECK(got.first.compare(qr.first) == 0 && got.second.compare(qr.second) == 0);
+            // Growth in place from malloc'd limbs across minLimbs into a mapping
+            BigInt grown(1);
+            for (int i = 0; i < 40; i++) grown *= y;
+            CHECK(grown.compare(power) == 0);
+            grown.adda(BigInt(1));
+            power.adda(BigInt(1));
+            CHECK(grown.compare(power) == 0);
+        }
+        setDefaultLimbAllocator(nullptr);
+        setScratchLimbAllocator(nullptr);
+    }
+#endif
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::map<std::string, void (*)()> groups = {
+        {"mult", testMult},
+        {"square", testSquare},
+        {"modpow", testModPow},
+        {"radix", testRadix},
+        {"divmod", testDivmod},
+        {"parallel", testParallel},
+        {"expr", testExpressions},
+        {"fixed", testFixed},
+        {"constants", testConstants},
+        {"views", testViews},
+        {"binary", testBinary},
+        {"mmap", testMmap},
+    };
+    if (argc > 1) {
+        auto it = groups.find(argv[1]);
+        if (it == groups.end()) {
+            std::cerr << "unknown test group " << argv[1] << "\n";
+            return 2;
+        }
+        it->second();
+    } else {
+        for (auto& g : groups) g.second();
+    }
+    if (failures) std::cerr << failures << " checks failed\n";
+    return failures ? 1 : 0;
+}